@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0
+//
+// GhostBrew - Trace Replay Benchmarks
+//
+// Replays real captured scheduler event sequences through the actual
+// userspace code paths (exe classification, ProfileManager matching,
+// latency percentiles) and the userspace DSQ-selection model, reporting
+// decisions/second and per-stage latency.
+//
+// Point GHOSTBREW_TRACE at a --record-events capture to benchmark against
+// a real workload; without one, the default ring path is tried and then a
+// deterministic synthetic trace keeps CI numbers comparable.
+//
+// Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
+
+use criterion::{Criterion, Throughput, criterion_group, criterion_main};
+use std::hint::black_box;
+use std::path::Path;
+
+use scx_ghostbrew::events::SchedEvent;
+use scx_ghostbrew::gaming;
+use scx_ghostbrew::mangohud::{HIST_BUCKETS, calculate_latency_percentiles};
+use scx_ghostbrew::profiles::{GameProfile, ProfileManager};
+use scx_ghostbrew::recorder::DEFAULT_RING_PATH;
+use scx_ghostbrew::replay::{self, DsqModel};
+
+/// Synthetic trace size when no capture is available
+const SYNTHETIC_EVENTS: usize = 65_536;
+
+/// Load the benchmark trace: GHOSTBREW_TRACE, then the default ring path,
+/// then the synthetic fallback
+fn load_bench_trace() -> Vec<SchedEvent> {
+    if let Ok(path) = std::env::var("GHOSTBREW_TRACE") {
+        match replay::load_trace(Path::new(&path)) {
+            Ok(trace) => {
+                eprintln!("replay_bench: {} events from {}", trace.len(), path);
+                return trace;
+            }
+            Err(e) => eprintln!("replay_bench: failed to load {}: {}", path, e),
+        }
+    }
+
+    if let Ok(trace) = replay::load_trace(Path::new(DEFAULT_RING_PATH)) {
+        eprintln!(
+            "replay_bench: {} events from {}",
+            trace.len(),
+            DEFAULT_RING_PATH
+        );
+        return trace;
+    }
+
+    eprintln!(
+        "replay_bench: no capture found, using {} synthetic events",
+        SYNTHETIC_EVENTS
+    );
+    replay::synthetic_trace(SYNTHETIC_EVENTS)
+}
+
+/// Representative profile set (exact exe, substring, and Steam App ID
+/// matches all exercised)
+fn bench_profiles() -> ProfileManager {
+    let mut manager = ProfileManager::new();
+    for (name, exe, appid) in [
+        ("Cyberpunk 2077", Some("cyberpunk"), Some(1091500u32)),
+        ("Elden Ring", Some("eldenring.exe"), Some(1245620)),
+        ("Counter-Strike 2", Some("cs2"), Some(730)),
+        ("Baldur's Gate 3", Some("bg3"), Some(1086940)),
+        ("Helldivers 2", Some("helldivers2"), None),
+        ("Star Citizen", Some("starcitizen"), None),
+    ] {
+        manager.insert_profile(GameProfile {
+            name: name.to_string(),
+            exe_name: exe.map(str::to_string),
+            steam_appid: appid,
+            ..Default::default()
+        });
+    }
+    manager
+}
+
+/// Per-stage: exe/comm classification (gaming::classify_exe_name)
+fn bench_classification(c: &mut Criterion) {
+    let trace = load_bench_trace();
+    let comms: Vec<String> = trace.iter().map(|e| e.comm_str()).collect();
+
+    let mut group = c.benchmark_group("replay_classification");
+    group.throughput(Throughput::Elements(comms.len() as u64));
+    group.bench_function("classify_exe_name", |b| {
+        b.iter(|| {
+            let mut gaming_count = 0u64;
+            for comm in &comms {
+                if gaming::classify_exe_name(comm) == Some(gaming::WORKLOAD_GAMING) {
+                    gaming_count += 1;
+                }
+            }
+            black_box(gaming_count)
+        });
+    });
+    group.finish();
+}
+
+/// Per-stage: profile matching (ProfileManager::match_process)
+fn bench_profile_matching(c: &mut Criterion) {
+    let trace = load_bench_trace();
+    let comms: Vec<String> = trace.iter().map(|e| e.comm_str()).collect();
+    let manager = bench_profiles();
+
+    let mut group = c.benchmark_group("replay_profile_match");
+    group.throughput(Throughput::Elements(comms.len() as u64));
+    group.bench_function("match_process", |b| {
+        b.iter(|| {
+            let mut hits = 0u64;
+            for comm in &comms {
+                if manager.match_process(comm, None).is_some() {
+                    hits += 1;
+                }
+            }
+            black_box(hits)
+        });
+    });
+    group.finish();
+}
+
+/// Per-stage: latency percentile math over the trace's histogram shape
+fn bench_percentiles(c: &mut Criterion) {
+    let trace = load_bench_trace();
+
+    // Build the BPF-shaped histogram once; the percentile math is the
+    // per-stats-tick cost being measured
+    let mut hist = [0u64; HIST_BUCKETS];
+    for event in &trace {
+        hist[(event.value1 / 1600).min(HIST_BUCKETS as u64 - 1) as usize] += 1;
+    }
+
+    let mut group = c.benchmark_group("replay_percentiles");
+    group.bench_function("calculate_latency_percentiles", |b| {
+        b.iter(|| black_box(calculate_latency_percentiles(black_box(&hist))));
+    });
+    group.finish();
+}
+
+/// Per-stage: DSQ selection model over the trace
+fn bench_dsq_selection(c: &mut Criterion) {
+    let trace = load_bench_trace();
+    let model = DsqModel::default_x3d(32);
+
+    let mut group = c.benchmark_group("replay_dsq_select");
+    group.throughput(Throughput::Elements(trace.len() as u64));
+    group.bench_function("select", |b| {
+        b.iter(|| {
+            let mut acc = 0u64;
+            for event in &trace {
+                let (dsq, vtime) = model.select(event.cpu, None, event.value2, false);
+                acc = acc.wrapping_add(dsq ^ vtime);
+            }
+            black_box(acc)
+        });
+    });
+    group.finish();
+}
+
+/// Full pipeline: classification + profile match + DSQ selection +
+/// percentile roll-up, reported as decisions/second
+fn bench_full_pipeline(c: &mut Criterion) {
+    let trace = load_bench_trace();
+    let mut manager = bench_profiles();
+    let model = DsqModel::default_x3d(32);
+
+    let mut group = c.benchmark_group("replay_pipeline");
+    group.throughput(Throughput::Elements(trace.len() as u64));
+    group.bench_function("decisions", |b| {
+        b.iter(|| black_box(replay::replay(&trace, &mut manager, &model)));
+    });
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_classification,
+    bench_profile_matching,
+    bench_percentiles,
+    bench_dsq_selection,
+    bench_full_pipeline,
+);
+
+criterion_main!(benches);
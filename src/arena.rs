@@ -1,20 +1,22 @@
 // SPDX-License-Identifier: GPL-2.0
 //
-// GhostBrew - BPF Arena Support (Placeholder)
+// GhostBrew - BPF Arena Stats Plane
 //
-// BPF Arena provides shared memory regions between BPF programs and userspace
-// for complex data structures like per-task history buffers.
+// BPF Arena provides shared memory regions between BPF programs and userspace.
+// The BPF side allocates a stats page at attach time and publishes per-CPU
+// stats, CCD loads, and the gaming latency histogram into it from ops.tick
+// (see arena_publish_stats in src/bpf/ghostbrew.bpf.c). Userspace reads the
+// snapshot directly through the mmapped arena - zero syscalls, zero copies -
+// instead of issuing one bpf_map_lookup per entry every stats interval.
 //
 // Requirements:
 // - Kernel 6.18+ with BPF_MAP_TYPE_ARENA support
-// - libbpf 1.5+
-// - scx_arena crate (when available)
-//
-// This module provides detection and future scaffolding.
+// - On older kernels the arena map is not created and readers fall back to
+//   per-map lookups.
 //
 // Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
 
-#![allow(dead_code)] // Scaffolding for future Arena implementation
+#![allow(dead_code)] // Some accessors are only used with --stats / MangoHud export
 
 use log::debug;
 use std::fs;
@@ -75,9 +77,9 @@ impl ArenaStatus {
 
         Self {
             supported,
-            enabled: false, // Not yet implemented
+            enabled: supported,
             reason: if supported {
-                "Arena support available but not yet implemented in this build".to_string()
+                "Arena stats plane active".to_string()
             } else {
                 "Requires kernel 6.18+ with BPF_MAP_TYPE_ARENA".to_string()
             },
@@ -91,6 +93,125 @@ impl Default for ArenaStatus {
     }
 }
 
+/// Schema version of the arena stats plane (matches ARENA_SCHEMA_VERSION in BPF)
+pub const ARENA_SCHEMA_VERSION: u64 = 1;
+
+/// Must match MAX_CPUS / MAX_CCDS / HIST_BUCKETS in src/bpf/ghostbrew.bpf.c
+pub const ARENA_MAX_CPUS: usize = 256;
+pub const ARENA_MAX_CCDS: usize = 8;
+pub const ARENA_HIST_BUCKETS: usize = 16;
+
+/// Per-CPU statistics, mirrors struct percpu_stats in BPF
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct PercpuStats {
+    pub enqueued: u64,
+    pub dispatched: u64,
+    pub gaming_tasks: u64,
+    pub latency_sum_ns: u64,
+    pub latency_count: u64,
+    pub latency_max_ns: u64,
+    pub idle_time_ns: u64,
+    pub busy_time_ns: u64,
+}
+
+/// Per-CCD load, mirrors struct ccd_load in BPF
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct CcdLoad {
+    pub nr_gaming: u64,
+    pub nr_tasks: u64,
+}
+
+/// Shared stats page layout, mirrors struct arena_stats_plane in BPF
+#[repr(C)]
+pub struct ArenaStatsPlane {
+    pub schema_version: u64,
+    /// Seqcount: odd while CPU 0 is publishing the CCD/histogram section
+    pub seq: u64,
+    pub ccd_loads: [CcdLoad; ARENA_MAX_CCDS],
+    pub gaming_latency_hist: [u64; ARENA_HIST_BUCKETS],
+    pub cpu_stats: [PercpuStats; ARENA_MAX_CPUS],
+}
+
+/// Consistent copy of the seqcount-protected section of the stats plane
+#[derive(Debug, Default, Clone)]
+pub struct ArenaSnapshot {
+    pub ccd_loads: [CcdLoad; ARENA_MAX_CCDS],
+    pub gaming_latency_hist: [u64; ARENA_HIST_BUCKETS],
+}
+
+/// Zero-syscall reader over the BPF-published arena stats page
+pub struct ArenaStatsReader {
+    plane: *const ArenaStatsPlane,
+}
+
+// The plane pointer targets the daemon's private arena mmap, which stays
+// valid for the lifetime of the loaded skeleton.
+unsafe impl Send for ArenaStatsReader {}
+
+impl ArenaStatsReader {
+    /// Build a reader from the userspace pointer published by the BPF side
+    /// (the `arena_stats_user` global set in ghostbrew_init).
+    ///
+    /// # Safety
+    /// `user_ptr` must be the value read from `arena_stats_user` after the
+    /// struct_ops link attached, while the skeleton (and thus the arena
+    /// mmap) is still alive.
+    pub unsafe fn from_user_ptr(user_ptr: u64) -> Option<Self> {
+        if user_ptr == 0 {
+            return None;
+        }
+
+        let plane = user_ptr as *const ArenaStatsPlane;
+        let version = unsafe { std::ptr::read_volatile(&(*plane).schema_version) };
+        if version != ARENA_SCHEMA_VERSION {
+            debug!(
+                "Arena stats plane schema mismatch: got {}, expected {}",
+                version, ARENA_SCHEMA_VERSION
+            );
+            return None;
+        }
+
+        debug!("Arena stats plane mapped at {:#x}", user_ptr);
+        Some(Self { plane })
+    }
+
+    /// Read one CPU's stats slot (updated by that CPU's tick, no locking)
+    pub fn cpu_stats(&self, cpu: usize) -> Option<PercpuStats> {
+        if cpu >= ARENA_MAX_CPUS {
+            return None;
+        }
+        Some(unsafe { std::ptr::read_volatile(&(*self.plane).cpu_stats[cpu]) })
+    }
+
+    /// Take a consistent snapshot of the CCD loads and latency histogram
+    ///
+    /// Uses the seqcount published by CPU 0: retry while the writer is
+    /// mid-publication or the sequence moved during the copy.
+    pub fn snapshot(&self) -> ArenaSnapshot {
+        loop {
+            let seq_start = unsafe { std::ptr::read_volatile(&(*self.plane).seq) };
+            if seq_start % 2 != 0 {
+                std::hint::spin_loop();
+                continue;
+            }
+
+            let snapshot = ArenaSnapshot {
+                ccd_loads: unsafe { std::ptr::read_volatile(&(*self.plane).ccd_loads) },
+                gaming_latency_hist: unsafe {
+                    std::ptr::read_volatile(&(*self.plane).gaming_latency_hist)
+                },
+            };
+
+            let seq_end = unsafe { std::ptr::read_volatile(&(*self.plane).seq) };
+            if seq_start == seq_end {
+                return snapshot;
+            }
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
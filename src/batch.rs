@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0
+//
+// GhostBrew - Batched BPF Map Updates
+//
+// The PID propagation paths (gaming_pids, vm_vcpu_pids, container_pids)
+// used to issue one bpf_map_update_elem/delete_elem syscall per PID. A
+// Steam game launching 200+ threads meant hundreds of syscalls in a single
+// poll tick. PidMapDiff stages all adds/removes for one map and commits
+// them with BPF_MAP_UPDATE_BATCH / BPF_MAP_DELETE_BATCH - a constant
+// number of syscalls per tick regardless of how many PIDs changed.
+//
+// Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
+
+use libbpf_rs::{MapCore, MapFlags};
+use log::debug;
+
+/// Staged PID -> workload-class changes for one u32/u32 hash map
+#[derive(Default)]
+pub struct PidMapDiff {
+    /// Packed keys for update_batch (4 bytes per PID)
+    update_keys: Vec<u8>,
+    /// Packed values for update_batch (4 bytes per class)
+    update_values: Vec<u8>,
+    nr_updates: u32,
+    /// Packed keys for delete_batch
+    delete_keys: Vec<u8>,
+    nr_deletes: u32,
+}
+
+impl PidMapDiff {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Stage an insert/overwrite of pid -> class
+    pub fn update(&mut self, pid: u32, class: u32) {
+        self.update_keys.extend_from_slice(&pid.to_ne_bytes());
+        self.update_values.extend_from_slice(&class.to_ne_bytes());
+        self.nr_updates += 1;
+    }
+
+    /// Stage a removal of pid
+    pub fn delete(&mut self, pid: u32) {
+        self.delete_keys.extend_from_slice(&pid.to_ne_bytes());
+        self.nr_deletes += 1;
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.nr_updates == 0 && self.nr_deletes == 0
+    }
+
+    /// Commit all staged changes to `map` in at most two batch syscalls.
+    ///
+    /// Falls back to per-element updates if the kernel rejects the batch
+    /// ops. Delete failures are ignored like the previous per-element path:
+    /// a PID that already vanished from the map is not an error.
+    pub fn commit<M: MapCore>(&self, map: &M, map_name: &str) {
+        if self.nr_updates > 0
+            && let Err(e) = map.update_batch(
+                &self.update_keys,
+                &self.update_values,
+                self.nr_updates,
+                MapFlags::ANY,
+                MapFlags::ANY,
+            )
+        {
+            debug!(
+                "Batch update of {} ({} PIDs) failed: {} - falling back",
+                map_name, self.nr_updates, e
+            );
+            for i in 0..self.nr_updates as usize {
+                let key = &self.update_keys[i * 4..(i + 1) * 4];
+                let value = &self.update_values[i * 4..(i + 1) * 4];
+                if let Err(e) = map.update(key, value, MapFlags::ANY) {
+                    debug!("Failed to update PID in {}: {}", map_name, e);
+                }
+            }
+        }
+
+        if self.nr_deletes > 0
+            && map
+                .delete_batch(
+                    &self.delete_keys,
+                    self.nr_deletes,
+                    MapFlags::ANY,
+                    MapFlags::ANY,
+                )
+                .is_err()
+        {
+            // Batch delete aborts on the first missing key; retry per-element
+            // so the remaining staged removals still land.
+            for i in 0..self.nr_deletes as usize {
+                let _ = map.delete(&self.delete_keys[i * 4..(i + 1) * 4]);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_diff_staging() {
+        let mut diff = PidMapDiff::new();
+        assert!(diff.is_empty());
+
+        diff.update(1234, 1);
+        diff.update(5678, 3);
+        diff.delete(999);
+
+        assert!(!diff.is_empty());
+        assert_eq!(diff.nr_updates, 2);
+        assert_eq!(diff.nr_deletes, 1);
+        assert_eq!(diff.update_keys.len(), 8);
+        assert_eq!(diff.update_values.len(), 8);
+        assert_eq!(diff.update_keys[0..4], 1234u32.to_ne_bytes());
+        assert_eq!(diff.update_values[4..8], 3u32.to_ne_bytes());
+        assert_eq!(diff.delete_keys[0..4], 999u32.to_ne_bytes());
+    }
+}
@@ -23,6 +23,7 @@
 #include <bpf/bpf_core_read.h>
 #include "scx/common.bpf.h"
 #include "scx/compat.bpf.h"
+#include "scx/bpf_arena_common.bpf.h"
 
 char _license[] SEC("license") = "GPL";
 
@@ -32,19 +33,89 @@ char _license[] SEC("license") = "GPL";
 #define GHOSTBREW_VERSION	"0.3.2"
 #define MAX_CPUS		256
 #define MAX_CCDS		8
+#define MAX_NUMA_NODES		8
 #define NSEC_PER_MSEC		1000000ULL
 #define NSEC_PER_SEC		1000000000ULL
 #define RINGBUF_SIZE		(256 * 1024)  /* 256KB ringbuf */
 
-/* DSQ IDs: 0 = fallback shared, 1-8 = per-CCD */
+/* DSQ IDs: 0 = fallback shared, 1.. = per-CCD tiers, then throttled */
 #define FALLBACK_DSQ		0
 #define CCD_DSQ_BASE		1
+#define NR_PRIO_TIERS		3	/* PRIO_GAMING..PRIO_BATCH, one DSQ each */
+#define THROTTLED_DSQ		(CCD_DSQ_BASE + MAX_CCDS * NR_PRIO_TIERS)
+#define NR_DSQS			(THROTTLED_DSQ + 1)
 
 /* Priority classes for preemption */
 #define PRIO_GAMING		0
 #define PRIO_INTERACTIVE	1
 #define PRIO_BATCH		2
 
+/* gpu_bound_mode values (see runtime_tunables) */
+#define GPU_MODE_BALANCED	0
+#define GPU_MODE_GPU_BOUND	1
+#define GPU_MODE_CPU_BOUND	2
+
+/*
+ * Frame pacing: gaming tasks waking at a stable rate in this band are
+ * treated as render threads pacing at their frame rate.
+ */
+#define FRAME_PACE_MIN_HZ	30
+#define FRAME_PACE_MAX_HZ	360
+#define FRAME_PACE_MIN_STABLE	8	/* Consecutive stable wakeups required */
+
+/*
+ * Busyloop throttling: non-gaming tasks that sustain a high wakeup
+ * frequency while doing almost no work per wake (spin-polling telemetry
+ * agents, some Wine worker threads) pay the full select_cpu/enqueue cost
+ * at 100Hz+ while their tiny bursts classify them as interactive. After
+ * BUSYLOOP_DEMOTE_WAKEUPS consecutive qualifying wakeups they are demoted
+ * to the shared THROTTLED_DSQ with BUSYLOOP_SLICE_MULT-wide slices,
+ * drained only after every priority tier - batching their wakes amortizes
+ * the machinery they used to run per wake. The exit frequency sits below
+ * the entry one so the verdict doesn't flap; dropping under it (or
+ * growing real bursts) promotes the task straight back.
+ */
+#define BUSYLOOP_MIN_FREQ_HZ	100	/* Entry: sustained wakeups above this */
+#define BUSYLOOP_EXIT_FREQ_HZ	50	/* Exit: behavior changed, promote back */
+#define BUSYLOOP_MAX_BURST_NS	(NSEC_PER_MSEC / 4)	/* "Almost no work" */
+#define BUSYLOOP_DEMOTE_WAKEUPS	32	/* Consecutive qualifying wakeups */
+#define BUSYLOOP_SLICE_MULT	4	/* Wide slices amortize wake overhead */
+
+/*
+ * Measured cache sensitivity (userspace L3-miss sampler; the score is a
+ * task's 0-100 L3 miss ratio over the last sampling interval). Above HOT
+ * a task benefits from the V-Cache CCD regardless of class; below COLD a
+ * nominally V-Cache-bound task's working set already fits in a normal L3
+ * and the extra 96MB is wasted on it.
+ */
+#define CACHE_SCORE_HOT		60
+#define CACHE_SCORE_COLD	10
+
+/*
+ * Adaptive event aggregation: above the high watermark of ringbuf
+ * occupancy, high-rate event types are coalesced per (type, pid) into
+ * counted records flushed by a timer; below the low watermark emission
+ * returns to per-event fidelity. Hysteresis keeps the mode from flapping.
+ */
+#define EVENT_AGG_HIGH_WM	(RINGBUF_SIZE / 2)
+#define EVENT_AGG_LOW_WM	(RINGBUF_SIZE / 4)
+#define EVENT_AGG_FLUSH_NS	(100 * 1000 * 1000ULL)	/* 100ms */
+
+/*
+ * Per-cgroup proportional sharing (cgroup v2 cpu.weight semantics).
+ * Batch runtime is charged to a shared per-cgroup vruntime scaled by
+ * CGROUP_DEFAULT_WEIGHT / weight; a cgroup can lead the slowest live
+ * cgroup by at most CGROUP_LAG_CAP_NS of weighted runtime before its
+ * tasks absorb the full batch-tier penalty.
+ */
+#define CGROUP_DEFAULT_WEIGHT	100
+#define CGROUP_LAG_CAP_NS	(100 * NSEC_PER_MSEC)
+
+/* Proactive CCD load balancer */
+#define CCD_BALANCE_INTERVAL_NS	(5 * 1000 * 1000ULL)	/* 5ms */
+#define CCD_BALANCE_MAX_MIGRATE	4	/* Tasks moved per timer firing */
+#define CCD_BALANCE_MIN_BACKLOG	2	/* Source batch-tier depth to act on */
+
 /*
  * Event types for ringbuf streaming
  */
@@ -54,6 +125,8 @@ char _license[] SEC("license") = "GPL";
 #define EVENT_HIGH_LATENCY	4   /* High scheduling latency observed */
 #define EVENT_CCD_IMBALANCE	5   /* CCD load imbalance detected */
 #define EVENT_PROFILE_MATCH	6   /* Game profile matched */
+#define EVENT_PROC_EXEC		7   /* Process exec (drives userspace classification) */
+#define EVENT_AGGREGATE		8   /* Coalesced record: value1 = type, value2 = count */
 
 /*
  * Event structure for ringbuf
@@ -85,11 +158,18 @@ struct percpu_stats {
 
 /*
  * Tunables (set from userspace via .rodata) - topology/static config
+ *
+ * The loader writes these before load, so the verifier sees them as known
+ * constants: CPU-scan loops bounded by nr_cpus_possible verify at the real
+ * machine size rather than MAX_CPUS, and branches guarded by the topology
+ * flags (Intel paths on AMD hosts, the X3D cross-CCD drain on flat parts)
+ * are dead-code-eliminated from the loaded program.
  */
 const volatile u32 nr_cpus_possible = 64;
 const volatile u32 nr_ccds = 2;
 const volatile u32 vcache_ccd = 0;
 const volatile bool smt_enabled = true;
+const volatile bool smt_isolation = true;  /* Keep batch off gaming SMT siblings */
 const volatile bool debug_mode = false;
 
 /*
@@ -115,8 +195,13 @@ const volatile bool is_intel_hybrid = false;
 const volatile u32 nr_pcores = 0;
 const volatile u32 nr_ecores = 0;
 const volatile u32 ecore_offload_mode = 1;  /* 0=disabled, 1=conservative, 2=aggressive */
+const volatile bool hfi_enabled = false;    /* Thread Director/HFI caps published */
+
+/* Arena stats plane - requires BPF_MAP_TYPE_ARENA (kernel 6.18+) */
+const volatile bool arena_enabled = false;
 
 /* Zen 5 specific support */
+const volatile bool is_x3d = false;         /* Stacked V-Cache present */
 const volatile u32 zen_generation = 0;      /* 4 = Zen 4, 5 = Zen 5, 0 = not AMD */
 const volatile u32 freq_ccd = 0;            /* Non-V-Cache CCD for freq-bound tasks */
 const volatile bool asymmetric_ccd_boost = false;  /* Zen 5 X3D: CCDs have different boost */
@@ -140,6 +225,7 @@ u64 nr_vcache_migrations = 0;
 u64 nr_ccd_local = 0;
 u64 nr_ccd_cross = 0;
 u64 nr_smt_idle_picks = 0;
+u64 nr_smt_isolations = 0;
 u64 nr_compaction_overflows = 0;
 u64 nr_preempt_kicks = 0;
 /* Phase 4a statistics */
@@ -158,6 +244,10 @@ u64 nr_ai_container_tasks = 0;
 /* Phase 4d statistics */
 u64 nr_cgroup_classifications = 0;
 u64 nr_cgroup_gaming = 0;
+u64 nr_cgroup_vtime_penalties = 0;
+
+/* Frontier (max charged) of the per-cgroup vruntimes, see cgroup_vtimes */
+static u64 cgroup_vtime_max;
 /* Intel hybrid statistics */
 u64 nr_pcore_placements = 0;
 u64 nr_ecore_offloads = 0;
@@ -177,23 +267,50 @@ u64 gaming_preempted = 0;        /* Gaming tasks preempted by other tasks */
 /* v0.3.0: Wakeup frequency tracking */
 u64 nr_high_wakeup_tasks = 0;    /* Tasks with wakeup_freq > 50Hz */
 u64 nr_wakeup_penalties = 0;     /* Times high-freq wakeup penalty applied */
+u64 nr_busyloop_demotions = 0;   /* Tasks demoted to the throttled DSQ */
+u64 nr_busyloop_promotions = 0;  /* Throttled tasks promoted back */
+u64 nr_cache_hot_promotions = 0; /* V-Cache granted on measured miss ratio */
+u64 nr_cache_cold_demotions = 0; /* V-Cache revoked on measured miss ratio */
+u64 nr_frame_paced = 0;          /* Deadline slices granted to render threads */
+u64 nr_gpu_relaxed_kicks = 0;    /* Preempt kicks skipped while GPU-bound */
+
+/*
+ * Classification generation counter.
+ *
+ * Bumped by userspace whenever the inputs to is_gaming_task() change
+ * (gaming_pids / cgroup_classes / vm_vcpu_pids / container_pids maps).
+ * A cached task verdict is valid only while its class_gen matches, so the
+ * comm string matching and parent-chain walk run once per task per
+ * generation instead of on every wakeup.
+ */
+u32 classification_gen = 0;
 /* v0.3.0: SMT contention avoidance */
 u64 nr_smt_contention_avoids = 0;  /* Times we avoided a contended SMT pair */
 /* v0.3.0: Futex-aware scheduling */
 u64 nr_futex_boosts = 0;           /* Times lock holder priority boost applied */
+u64 nr_futex_pi_boosts = 0;        /* Lock holders inherited a gaming waiter's priority */
 /* v0.3.0: Core compaction / power mode */
 u64 nr_power_compactions = 0;      /* Times core compaction was applied */
 u64 system_util_pct = 50;          /* System utilization percentage */
-/* v0.3.0: Latency histograms (logarithmic buckets) */
+/* v0.3.0: Latency histograms (logarithmic buckets, per-CPU map below) */
 #define HIST_BUCKETS 16
-u64 gaming_latency_hist[HIST_BUCKETS] = {};  /* Latency histogram for gaming tasks */
 /* v0.3.0: GPU coordination */
 u64 nr_gpu_feeder_boosts = 0;      /* Times GPU feeder threads were boosted */
+/* Idle cpumask fast path */
+u64 nr_idle_mask_picks = 0;        /* Idle CPUs found via maintained cpumasks */
+/* Proactive CCD load balancing */
+u64 nr_ccd_balance_migrations = 0; /* Queued batch tasks moved between CCDs */
+/* Pinned-task fast path */
+u64 nr_pinned_dispatches = 0;      /* Direct dispatches of single-CPU tasks */
+/* Adaptive event aggregation */
+u64 nr_events_aggregated = 0;      /* Events coalesced instead of emitted directly */
+u32 event_agg_mode = 0;            /* 1 while ringbuf occupancy is above the watermark */
 
 /*
  * v0.3.0: Task flags for special handling
  */
 #define TASK_FLAG_FUTEX_HOLDER	(1 << 0)  /* Task currently holds a futex lock */
+#define TASK_FLAG_PI_BOOSTED	(1 << 1)  /* Holder inherited a gaming waiter's priority */
 
 /*
  * v0.3.0: Power mode thresholds
@@ -273,6 +390,30 @@ struct {
 	__type(value, u32);
 } gaming_pids SEC(".maps");
 
+/*
+ * Futex owners - {tgid, uaddr} -> holder PID, maintained by the futex
+ * fexit hooks. Lets a gaming waiter find the task it is blocked behind so
+ * priority inheritance can promote the holder. LRU so abandoned locks age
+ * out.
+ *
+ * Private futexes (the glibc default) are per-address-space, and the same
+ * virtual address is routinely a different lock in unrelated processes,
+ * so the owning tgid is part of the key - a waiter can only ever match a
+ * holder within its own address space.
+ */
+struct futex_owner_key {
+	u64 uaddr;
+	u32 tgid;
+	u32 _pad;		/* Zeroed: hash keys include padding bytes */
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, 4096);
+	__type(key, struct futex_owner_key);
+	__type(value, u32);
+} futex_owners SEC(".maps");
+
 /*
  * CPU prefcore rankings - populated by userspace from amd_pstate
  * Higher values = AMD prefers this core for boosting
@@ -284,6 +425,23 @@ struct {
 	__type(value, u32);
 } prefcore_rankings SEC(".maps");
 
+/*
+ * Per-CPU hardware feedback capabilities (Intel Thread Director / HFI),
+ * normalized to 0-1023 and refreshed periodically by userspace from the
+ * HWP/CPPC capability registers. Zero means no data for that CPU.
+ */
+struct hfi_cap {
+	u32 perf_cap;   /* Performance capability */
+	u32 eff_cap;    /* Efficiency (sustained) capability */
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_CPUS);
+	__type(key, u32);
+	__type(value, struct hfi_cap);
+} cpu_hfi_caps SEC(".maps");
+
 /*
  * VM vCPU PIDs - populated by userspace from QEMU/KVM detection
  * Key: PID, Value: workload class (WORKLOAD_VM_DEV, WORKLOAD_VM_GAMING, etc.)
@@ -317,6 +475,20 @@ struct {
 	__type(value, u32);
 } numa_hints SEC(".maps");
 
+/*
+ * Per-process cache-sensitivity scores, keyed by tgid - populated by the
+ * userspace L3-miss sampler (per-process perf LLC counters, inherited
+ * across threads; the amd_l3 uncore PMU cannot be attached per task).
+ * Value is the 0-100 miss ratio over the last sampling interval; an
+ * absent entry means unmeasured, class decides.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, 4096);
+	__type(key, u32);
+	__type(value, u32);
+} task_cache_scores SEC(".maps");
+
 /*
  * Cgroup classification - populated by userspace from cgroup path analysis
  * Key: cgroup ID (u64), Value: workload class
@@ -329,6 +501,35 @@ struct {
 	__type(value, u32);
 } cgroup_classes SEC(".maps");
 
+/*
+ * Per-cgroup scheduling weights - populated by userspace from cgroup v2
+ * cpu.weight (1-10000). Absent entries mean CGROUP_DEFAULT_WEIGHT.
+ * Key: cgroup ID (u64), Value: weight
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, 8192);
+	__type(key, u64);
+	__type(value, u32);
+} cgroup_weights SEC(".maps");
+
+/*
+ * Per-cgroup weight-scaled vruntime - charged in ghostbrew_stopping,
+ * consumed as a batch-tier vtime penalty in ghostbrew_enqueue. Every
+ * thread in a cgroup charges the same shared account, so thread count
+ * stops buying scheduling share. Keyed by cgroup ID rather than cgroup
+ * local storage because the struct_ops hooks only have an untrusted
+ * kn->id from a CO-RE read, not a trusted cgroup pointer. LRU so dead
+ * cgroups age out under churn.
+ * Key: cgroup ID (u64), Value: vruntime in weighted ns
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, 8192);
+	__type(key, u64);
+	__type(value, u64);
+} cgroup_vtimes SEC(".maps");
+
 /*
  * Ringbuf for real-time event streaming to userspace
  * Events include: gaming detection, migrations, preemptions, latency spikes
@@ -338,6 +539,33 @@ struct {
 	__uint(max_entries, RINGBUF_SIZE);
 } events SEC(".maps");
 
+/*
+ * Pending coalesced events, keyed by (type, pid). Populated by emit_event
+ * while aggregate mode is active, drained into EVENT_AGGREGATE records by
+ * the flush timer. LRU so a PID churn storm evicts rather than fills.
+ */
+struct agg_key {
+	u32 event_type;
+	u32 pid;
+};
+
+struct agg_event {
+	u64 count;
+	u64 first_ns;		/* First coalesced occurrence */
+	u64 value1;		/* From the most recent occurrence */
+	u64 value2;
+	u32 cpu;
+	u32 ccd;
+	char comm[TASK_COMM_LEN];
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	__uint(max_entries, 512);
+	__type(key, struct agg_key);
+	__type(value, struct agg_event);
+} agg_events SEC(".maps");
+
 /*
  * PerCPU statistics - lock-free per-CPU counters
  * Aggregated by userspace for global stats with better scalability
@@ -349,6 +577,73 @@ struct {
 	__type(value, struct percpu_stats);
 } percpu_stats SEC(".maps");
 
+/*
+ * Per-CPU scheduling latency histograms, one per priority class.
+ *
+ * Previously a single shared global array updated with atomics from every
+ * CPU's running path, so all cores hammered the same 16 cache lines. Each
+ * CPU now bumps its own copy without atomics; readers (userspace stats,
+ * arena publish) merge the copies at read time. Per-class rows let the
+ * gaming p99 be tracked without batch noise.
+ */
+struct latency_hists {
+	u64 hist[NR_PRIO_TIERS][HIST_BUCKETS];
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, u32);
+	__type(value, struct latency_hists);
+} latency_hists SEC(".maps");
+
+/*
+ * Per-DSQ queue-depth tracking for tuning slice_ns and kick thresholds.
+ *
+ * ccd_loads only shows instantaneous running counts; this records, for
+ * every DSQ, the deepest backlog seen and a depth*time integral so
+ * userspace can report the time-weighted average depth over the run
+ * (integral / (last - first)). Noted at every enqueue and every
+ * successful dispatch drain. Writes are non-atomic best-effort like the
+ * global latency bounds - the depths are observational, not control
+ * inputs.
+ */
+struct dsq_depth_stat {
+	u64 depth_hwm;         /* Deepest backlog observed */
+	u64 depth_time_ns;     /* Integral of depth over time (depth * ns) */
+	u64 last_depth;        /* Depth at the last observation */
+	u64 first_update_ns;   /* First observation (for averaging) */
+	u64 last_update_ns;    /* Most recent observation */
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, NR_DSQS);
+	__type(key, u32);
+	__type(value, struct dsq_depth_stat);
+} dsq_depth_stats SEC(".maps");
+
+/*
+ * Cross-CCD steal accounting, per-CPU like latency_hists (each CPU bumps
+ * its own copy in ops.running, userspace merges at read time). Rows are
+ * keyed by the stealing (destination) CCD; the age histogram shares the
+ * latency_to_bucket() scale so it reads on the same axis as the latency
+ * percentiles.
+ */
+struct steal_stats {
+	u64 nr_steals[MAX_CCDS];     /* Tasks pulled from another CCD's DSQ */
+	u64 age_sum_ns[MAX_CCDS];    /* Queue age of stolen tasks */
+	u64 age_max_ns[MAX_CCDS];
+	u64 age_hist[HIST_BUCKETS];  /* latency_to_bucket() scale */
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, u32);
+	__type(value, struct steal_stats);
+} steal_stats SEC(".maps");
+
 /*
  * CPU performance state - updated by ops.tick
  * Tracks per-CPU performance (from scx_bpf_cpuperf_cur) for smarter placement
@@ -398,6 +693,149 @@ struct {
 	__type(value, struct cpu_run_state);
 } cpu_run_states SEC(".maps");
 
+/*
+ * Maintained idle cpumasks - one per CCD, per NUMA node, and per core type.
+ *
+ * These replace the per-CPU linear scans in the idle-pick helpers: instead of
+ * walking nr_cpus_possible entries calling scx_bpf_test_and_clear_cpu_idle(),
+ * we keep a bpf_cpumask per scheduling domain updated incrementally from
+ * ghostbrew_running/ghostbrew_stopping and pick with a single
+ * bpf_cpumask_any_and_distribute(). The masks are advisory - the final claim
+ * still goes through scx_bpf_test_and_clear_cpu_idle() so a stale bit only
+ * costs us the fallback scan, never a double placement.
+ */
+struct idle_cpumask_wrapper {
+	struct bpf_cpumask __kptr *mask;
+};
+
+/* Per-CCD idle masks */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_CCDS);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} ccd_idle_masks SEC(".maps");
+
+/*
+ * Per-CCD whole-core-idle masks: a CPU is a member only while both it and
+ * its SMT sibling are idle. Lets the prefer_smt_idle path claim a fully
+ * idle physical core with one cpumask op instead of testing every CPU
+ * against the kernel's idle_smtmask.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_CCDS);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} ccd_core_idle_masks SEC(".maps");
+
+/* Per-NUMA-node idle masks */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_NUMA_NODES);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} node_idle_masks SEC(".maps");
+
+/* Per-core-type idle masks (Intel hybrid): 0 = P-cores, 1 = E-cores */
+#define CORE_TYPE_PCORE		0
+#define CORE_TYPE_ECORE		1
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 2);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} core_type_idle_masks SEC(".maps");
+
+/*
+ * Per-CCD preemption victim index.
+ *
+ * One cpumask per CCD and preemptible priority class, tracking which CPUs
+ * are currently running batch resp. interactive tasks. Maintained from
+ * ghostbrew_running/ghostbrew_stopping alongside cpu_run_states, so
+ * find_kick_victim_in_ccd() is a single cpumask pick instead of a linear
+ * scan over every CPU's run state on each gaming enqueue. Like the idle
+ * masks these are advisory - the pick is revalidated against
+ * cpu_run_states before the kick.
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_CCDS);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} ccd_batch_run_masks SEC(".maps");
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, MAX_CCDS);
+	__type(key, u32);
+	__type(value, struct idle_cpumask_wrapper);
+} ccd_interactive_run_masks SEC(".maps");
+
+/*
+ * BPF timer driving the proactive CCD load balancer (see
+ * ccd_balance_timerfn). Armed once from ghostbrew_init on multi-CCD parts.
+ */
+struct balance_timer {
+	struct bpf_timer timer;
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, u32);
+	__type(value, struct balance_timer);
+} balance_timer_map SEC(".maps");
+
+/*
+ * BPF timer flushing coalesced events (see agg_flush_timerfn). Armed once
+ * from ghostbrew_init.
+ */
+struct agg_timer {
+	struct bpf_timer timer;
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, u32);
+	__type(value, struct agg_timer);
+} agg_timer_map SEC(".maps");
+
+/*
+ * Arena stats plane - shared memory between BPF and the daemon
+ *
+ * The per-interval stats readers in userspace (print_stats, MangoHud export)
+ * used to issue one bpf_map_lookup syscall per CPU/CCD entry. Instead, the
+ * BPF side publishes per-CPU stats, CCD loads, and the gaming latency
+ * histogram into an arena page from ops.tick; userspace mmaps the arena and
+ * reads the snapshot with zero syscalls and zero copies.
+ *
+ * Layout must stay in sync with ArenaStatsPlane in src/arena.rs.
+ */
+#define ARENA_STATS_PAGES	8
+#define ARENA_SCHEMA_VERSION	1
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARENA);
+	__uint(map_flags, BPF_F_MMAPABLE);
+	__uint(max_entries, ARENA_STATS_PAGES);
+} arena SEC(".maps");
+
+struct arena_stats_plane {
+	u64 schema_version;	/* ARENA_SCHEMA_VERSION */
+	u64 seq;		/* seqcount: odd while CPU 0 is publishing */
+	struct ccd_load ccd_loads[MAX_CCDS];
+	u64 gaming_latency_hist[HIST_BUCKETS];
+	struct percpu_stats cpu_stats[MAX_CPUS];
+};
+
+/* Kernel-side view of the stats page, set up in ghostbrew_init */
+struct arena_stats_plane __arena *arena_stats;
+/* Userspace pointer to the same page (valid in the daemon's address space) */
+u64 arena_stats_user = 0;
+
 /*
  * Workload classification types
  */
@@ -418,18 +856,23 @@ struct task_ctx {
 	u64 last_run_at;
 	u64 enqueue_at;			/* When task was enqueued (for latency tracking) */
 	u64 classification_time;	/* When was classification done */
+	u32 class_gen;			/* classification_gen at classify time */
 	/* v0.3.0: Wakeup frequency tracking */
 	u64 last_wakeup_at;		/* Timestamp of last wakeup */
 	u64 avg_wakeup_interval;	/* EWMA of inter-wakeup time (ns) */
-	u32 wakeup_freq_hz;		/* Calculated wakeup frequency (capped at 100Hz) */
+	u32 wakeup_freq_hz;		/* Calculated wakeup frequency (capped at 1000Hz) */
+	u32 stable_wakeups;		/* Consecutive wakeups near the EWMA period */
+	u32 busyloop_streak;		/* Consecutive high-freq tiny-burst wakeups */
 	u32 preferred_ccd;
 	u32 last_ccd;
+	u32 enqueue_ccd;		/* CCD whose DSQ holds the task (MAX_CCDS = shared DSQ) */
 	u32 workload_class;		/* WORKLOAD_* type */
 	bool is_gaming;
 	bool is_interactive;
 	bool is_proton;			/* Specifically Wine/Proton task */
 	bool is_gpu_feeder;		/* GPU-feeding thread (Vulkan/OpenGL) */
 	bool wants_vcache;
+	bool is_throttled;		/* Demoted busyloop offender */
 	bool classification_valid;	/* Has been classified */
 	u8 flags;			/* v0.3.0: Task flags (futex holder, etc.) */
 };
@@ -531,6 +974,60 @@ static inline struct percpu_stats *get_percpu_stats(void)
 	return bpf_map_lookup_elem(&percpu_stats, &key);
 }
 
+/*
+ * Helper: Get this CPU's latency histograms
+ */
+static inline struct latency_hists *get_latency_hists(void)
+{
+	u32 key = 0;
+	return bpf_map_lookup_elem(&latency_hists, &key);
+}
+
+/*
+ * Helper: Get this CPU's cross-CCD steal stats
+ */
+static inline struct steal_stats *get_steal_stats(void)
+{
+	u32 key = 0;
+	return bpf_map_lookup_elem(&steal_stats, &key);
+}
+
+/*
+ * Record a depth observation for a DSQ.
+ *
+ * Advances the depth*time integral by the depth that held since the last
+ * observation, then records the new depth. Called after every enqueue
+ * insert and every successful dispatch drain, so the integral covers
+ * exactly the intervals where the depth could have changed.
+ */
+static void dsq_depth_note(u64 dsq_id)
+{
+	struct dsq_depth_stat *st;
+	u32 key = dsq_id;
+	u64 now, depth;
+	s32 queued;
+
+	if (key >= NR_DSQS)
+		return;
+
+	st = bpf_map_lookup_elem(&dsq_depth_stats, &key);
+	if (!st)
+		return;
+
+	now = bpf_ktime_get_ns();
+	queued = scx_bpf_dsq_nr_queued(dsq_id);
+	depth = queued > 0 ? (u64)queued : 0;
+
+	if (depth > st->depth_hwm)
+		st->depth_hwm = depth;
+	if (st->first_update_ns == 0)
+		st->first_update_ns = now;
+	else if (now > st->last_update_ns)
+		st->depth_time_ns += st->last_depth * (now - st->last_update_ns);
+	st->last_depth = depth;
+	st->last_update_ns = now;
+}
+
 /*
  * Helper: Get CPU performance state
  */
@@ -540,6 +1037,16 @@ static inline struct cpu_perf_state *get_cpu_perf_state(s32 cpu)
 	return bpf_map_lookup_elem(&cpu_perf_states, &key);
 }
 
+/*
+ * The high-rate event types worth coalescing. The low-rate ones
+ * (detection, migrations, exec) keep per-event fidelity in either mode.
+ */
+static inline bool event_type_aggregates(u32 event_type)
+{
+	return event_type == EVENT_PREEMPT_KICK ||
+	       event_type == EVENT_HIGH_LATENCY;
+}
+
 /*
  * Helper: Emit event to ringbuf (non-blocking)
  * Returns 0 on success, -1 if ringbuf is full
@@ -549,6 +1056,51 @@ static inline int emit_event(u32 event_type, u32 pid, s32 cpu, u32 ccd,
 {
 	struct sched_event *event;
 
+	/*
+	 * Adaptive aggregation: when the ringbuf fills faster than userspace
+	 * drains it, coalesce the high-rate types per (type, pid) instead of
+	 * dropping exactly the records a contended session needs. The flush
+	 * timer emits the counted records and lowers event_agg_mode once
+	 * occupancy falls back below the low watermark.
+	 */
+	if (event_type_aggregates(event_type)) {
+		if (!event_agg_mode &&
+		    bpf_ringbuf_query(&events, BPF_RB_AVAIL_DATA) > EVENT_AGG_HIGH_WM)
+			event_agg_mode = 1;
+
+		if (event_agg_mode) {
+			struct agg_key key = {
+				.event_type = event_type,
+				.pid = pid,
+			};
+			struct agg_event *agg, init = {};
+
+			agg = bpf_map_lookup_elem(&agg_events, &key);
+			if (!agg) {
+				init.first_ns = bpf_ktime_get_ns();
+				bpf_map_update_elem(&agg_events, &key, &init,
+						    BPF_NOEXIST);
+				agg = bpf_map_lookup_elem(&agg_events, &key);
+			}
+			if (agg) {
+				__sync_fetch_and_add(&agg->count, 1);
+				agg->value1 = value1;
+				agg->value2 = value2;
+				agg->cpu = cpu >= 0 ? cpu : 0;
+				agg->ccd = ccd;
+				if (comm) {
+					#pragma unroll
+					for (int i = 0; i < 15 && comm[i]; i++)
+						agg->comm[i] = comm[i];
+					agg->comm[15] = '\0';
+				}
+				__sync_fetch_and_add(&nr_events_aggregated, 1);
+				return 0;
+			}
+			/* Map full: fall through to direct emission */
+		}
+	}
+
 	event = bpf_ringbuf_reserve(&events, sizeof(*event), 0);
 	if (!event)
 		return -1;  /* Ringbuf full, drop event */
@@ -576,13 +1128,75 @@ static inline int emit_event(u32 event_type, u32 pid, s32 cpu, u32 ccd,
 }
 
 /*
- * Helper: Get DSQ ID for a CCD
+ * Drain one coalesced entry into an EVENT_AGGREGATE record. The record
+ * carries the original type in value1, the occurrence count in value2, and
+ * the start of the coalescing window as its timestamp.
  */
-static u64 ccd_to_dsq(u32 ccd)
+static u64 agg_flush_one(struct bpf_map *map, struct agg_key *key,
+			 struct agg_event *agg, void *ctx)
 {
-	if (ccd >= MAX_CCDS)
+	struct sched_event *event;
+
+	if (!agg->count)
+		goto out;
+
+	event = bpf_ringbuf_reserve(&events, sizeof(*event), 0);
+	if (!event)
+		goto out;
+
+	event->timestamp_ns = agg->first_ns;
+	event->event_type = EVENT_AGGREGATE;
+	event->pid = key->pid;
+	event->cpu = agg->cpu;
+	event->ccd = agg->ccd;
+	event->value1 = key->event_type;
+	event->value2 = agg->count;
+	__builtin_memcpy(event->comm, agg->comm, TASK_COMM_LEN);
+	bpf_ringbuf_submit(event, 0);
+
+out:
+	bpf_map_delete_elem(map, key);
+	return 0;
+}
+
+static int agg_flush_timerfn(void *map, int *key, struct bpf_timer *timer)
+{
+	bpf_for_each_map_elem(&agg_events, agg_flush_one, NULL, 0);
+
+	/* Hysteresis: leave aggregate mode only once the backlog drained */
+	if (event_agg_mode &&
+	    bpf_ringbuf_query(&events, BPF_RB_AVAIL_DATA) < EVENT_AGG_LOW_WM)
+		event_agg_mode = 0;
+
+	bpf_timer_start(timer, EVENT_AGG_FLUSH_NS, 0);
+	return 0;
+}
+
+/*
+ * Helper: Get DSQ ID for a CCD and priority tier
+ *
+ * Each CCD owns NR_PRIO_TIERS DSQs, one per priority class.
+ * ghostbrew_dispatch drains them in strict priority order, so a gaming
+ * dispatch never traverses vtime-sorted batch entries even when a
+ * batch-heavy workload floods the CCD.
+ */
+static u64 ccd_prio_dsq(u32 ccd, u32 prio)
+{
+	if (ccd >= MAX_CCDS || prio >= NR_PRIO_TIERS)
 		return FALLBACK_DSQ;
-	return CCD_DSQ_BASE + ccd;
+	return CCD_DSQ_BASE + ccd * NR_PRIO_TIERS + prio;
+}
+
+/*
+ * Helper: Any tasks queued on any of a CCD's priority tiers?
+ */
+static bool ccd_has_queued(u32 ccd)
+{
+	for (u32 prio = 0; prio < NR_PRIO_TIERS; prio++) {
+		if (scx_bpf_dsq_nr_queued(ccd_prio_dsq(ccd, prio)) > 0)
+			return true;
+	}
+	return false;
 }
 
 /*
@@ -711,6 +1325,21 @@ static u32 check_container_hint(struct task_struct *p)
 	return 0;
 }
 
+/*
+ * Helper: Resolve a task's cgroup ID (kn->id of its default cgroup)
+ * Returns 0 if unavailable
+ */
+static u64 get_task_cgroup_id(struct task_struct *p)
+{
+	struct cgroup *cgrp;
+
+	cgrp = BPF_CORE_READ(p, cgroups, dfl_cgrp);
+	if (!cgrp)
+		return 0;
+
+	return BPF_CORE_READ(cgrp, kn, id);
+}
+
 /*
  * Helper: Check cgroup classification
  * Looks up task's cgroup ID in the cgroup_classes map populated by userspace
@@ -718,17 +1347,10 @@ static u32 check_container_hint(struct task_struct *p)
  */
 static u32 check_cgroup_class(struct task_struct *p)
 {
-	struct cgroup *cgrp;
 	u64 cgid;
 	u32 *class;
 
-	/* Get the task's default cgroup */
-	cgrp = BPF_CORE_READ(p, cgroups, dfl_cgrp);
-	if (!cgrp)
-		return 0;
-
-	/* Get cgroup ID from kernfs node */
-	cgid = BPF_CORE_READ(cgrp, kn, id);
+	cgid = get_task_cgroup_id(p);
 	if (!cgid)
 		return 0;
 
@@ -744,6 +1366,78 @@ static u32 check_cgroup_class(struct task_struct *p)
 	return 0;
 }
 
+/*
+ * Helper: Charge weight-scaled runtime to the task's cgroup vruntime
+ *
+ * delta is scaled by CGROUP_DEFAULT_WEIGHT / weight, so a weight-1000
+ * cgroup accrues vruntime 10x slower than the default and a weight-10
+ * one 10x faster. All threads of a cgroup charge the same account, which
+ * is what makes a 500-thread low-weight container unable to out-schedule
+ * a 4-thread high-weight service.
+ */
+static void charge_cgroup_vtime(struct task_struct *p, u64 delta)
+{
+	u64 cgid, charged, *vtime;
+	u32 *weight;
+
+	cgid = get_task_cgroup_id(p);
+	if (!cgid)
+		return;
+
+	weight = bpf_map_lookup_elem(&cgroup_weights, &cgid);
+	charged = delta * CGROUP_DEFAULT_WEIGHT /
+		  (weight && *weight ? *weight : CGROUP_DEFAULT_WEIGHT);
+
+	vtime = bpf_map_lookup_elem(&cgroup_vtimes, &cgid);
+	if (!vtime) {
+		/* New cgroups start at the floor: no penalty, no credit */
+		u64 init = cgroup_vtime_max > CGROUP_LAG_CAP_NS ?
+			   cgroup_vtime_max - CGROUP_LAG_CAP_NS : 0;
+
+		bpf_map_update_elem(&cgroup_vtimes, &cgid, &init, BPF_NOEXIST);
+		vtime = bpf_map_lookup_elem(&cgroup_vtimes, &cgid);
+		if (!vtime)
+			return;
+	}
+
+	__sync_fetch_and_add(vtime, charged);
+
+	/* Advance the frontier (racy read-then-write is benign here) */
+	if (*vtime > cgroup_vtime_max)
+		cgroup_vtime_max = *vtime;
+}
+
+/*
+ * Helper: Batch-tier vtime penalty from the cgroup's vruntime
+ *
+ * Returns the cgroup's vruntime lead over the lag-capped floor, scaled
+ * down to stay comparable with the burst-derived batch vtime. Cgroups at
+ * or below the floor pay nothing and are clamped up to it, so a cgroup
+ * that slept for an hour cannot bank an hour of credit.
+ */
+static u64 cgroup_vtime_penalty(struct task_struct *p)
+{
+	u64 cgid, *vtime, floor;
+	u64 vmax = cgroup_vtime_max;
+
+	cgid = get_task_cgroup_id(p);
+	if (!cgid)
+		return 0;
+
+	vtime = bpf_map_lookup_elem(&cgroup_vtimes, &cgid);
+	if (!vtime)
+		return 0;
+
+	floor = vmax > CGROUP_LAG_CAP_NS ? vmax - CGROUP_LAG_CAP_NS : 0;
+	if (*vtime <= floor) {
+		*vtime = floor;
+		return 0;
+	}
+
+	__sync_fetch_and_add(&nr_cgroup_vtime_penalties, 1);
+	return (*vtime - floor) / 1000;
+}
+
 /*
  * Helper: Walk parent chain looking for gaming indicators
  * Returns: 0 = not gaming, 1 = gaming, 2 = proton
@@ -789,9 +1483,10 @@ static bool is_gaming_task(struct task_struct *p)
 	u32 hint;
 	bool gpu_feeder = false;
 
-	/* Check cache first */
+	/* Check cache first - valid only for the current generation */
 	tctx = get_task_ctx(p);
-	if (tctx && tctx->classification_valid)
+	if (tctx && tctx->classification_valid &&
+	    tctx->class_gen == classification_gen)
 		return tctx->is_gaming;
 
 	/* Level 1: Direct comm check (fastest) */
@@ -864,26 +1559,32 @@ static bool is_gaming_task(struct task_struct *p)
 
 		tctx->classification_valid = true;
 		tctx->classification_time = bpf_ktime_get_ns();
+		tctx->class_gen = classification_gen;
 	}
 	return false;
 
 found_gaming:
 	if (tctx) {
+		bool was_gaming = tctx->classification_valid && tctx->is_gaming;
+
 		tctx->is_gaming = true;
 		tctx->is_proton = (gaming_type == 2);
 		tctx->is_gpu_feeder = gpu_feeder;
 		tctx->workload_class = WORKLOAD_GAMING;
 		tctx->classification_valid = true;
 		tctx->classification_time = bpf_ktime_get_ns();
-
-		/* Emit gaming detection event (only on first classification) */
-		emit_event(EVENT_GAMING_DETECTED,
-			   BPF_CORE_READ(p, tgid),
-			   scx_bpf_task_cpu(p),
-			   0,  /* CCD determined later */
-			   gaming_type,  /* 1=gaming, 2=proton */
-			   gpu_feeder ? 1 : 0,
-			   comm);
+		tctx->class_gen = classification_gen;
+
+		/* Emit gaming detection event (only on first classification;
+		 * a generation bump that reconfirms the verdict stays quiet) */
+		if (!was_gaming)
+			emit_event(EVENT_GAMING_DETECTED,
+				   BPF_CORE_READ(p, tgid),
+				   scx_bpf_task_cpu(p),
+				   0,  /* CCD determined later */
+				   gaming_type,  /* 1=gaming, 2=proton */
+				   gpu_feeder ? 1 : 0,
+				   comm);
 	}
 	if (gaming_type == 2)
 		__sync_fetch_and_add(&nr_proton_tasks, 1);
@@ -900,6 +1601,182 @@ static u32 get_prefcore_ranking(s32 cpu)
 	return ranking ? *ranking : 0;
 }
 
+/*
+ * Helper: Get the published HFI performance capability for a CPU (0 if none)
+ */
+static u32 get_hfi_perf_cap(s32 cpu)
+{
+	u32 key = cpu;
+	struct hfi_cap *cap = bpf_map_lookup_elem(&cpu_hfi_caps, &key);
+	return cap ? cap->perf_cap : 0;
+}
+
+/*
+ * Ranking for P-core picks: prefer the live Thread Director / HFI
+ * performance capability when userspace publishes it, falling back to the
+ * static prefcore/turbo ranking.
+ */
+static u32 pcore_ranking(s32 cpu)
+{
+	if (hfi_enabled) {
+		u32 cap = get_hfi_perf_cap(cpu);
+		if (cap)
+			return cap;
+	}
+	return get_prefcore_ranking(cpu);
+}
+
+/*
+ * Idle cpumask maintenance helpers
+ *
+ * The wrapped kptr masks are read under RCU; updates are advisory (see the
+ * map definitions above), so we never need stronger synchronization here.
+ */
+static void idle_mask_update(void *map, u32 idx, s32 cpu, bool idle)
+{
+	struct idle_cpumask_wrapper *wrap;
+	struct bpf_cpumask *mask;
+
+	wrap = bpf_map_lookup_elem(map, &idx);
+	if (!wrap)
+		return;
+
+	bpf_rcu_read_lock();
+	mask = wrap->mask;
+	if (mask) {
+		if (idle)
+			bpf_cpumask_set_cpu(cpu, mask);
+		else
+			bpf_cpumask_clear_cpu(cpu, mask);
+	}
+	bpf_rcu_read_unlock();
+}
+
+/*
+ * Test @cpu's membership in a wrapped mask (advisory, like the updates)
+ */
+static bool cpu_in_mask(void *map, u32 idx, s32 cpu)
+{
+	struct idle_cpumask_wrapper *wrap;
+	struct bpf_cpumask *mask;
+	bool set = false;
+
+	wrap = bpf_map_lookup_elem(map, &idx);
+	if (!wrap)
+		return false;
+
+	bpf_rcu_read_lock();
+	mask = wrap->mask;
+	if (mask)
+		set = bpf_cpumask_test_cpu(cpu, cast_mask(mask));
+	bpf_rcu_read_unlock();
+
+	return set;
+}
+
+/*
+ * Maintain the per-CCD whole-core-idle mask for @cpu's physical core.
+ *
+ * A core enters the mask only once both siblings are idle (checked against
+ * the per-CPU ccd_idle_masks, which update_idle_masks refreshes first) and
+ * leaves it the moment either sibling starts running.
+ */
+static void update_core_idle_mask(struct cpu_ctx *cctx, s32 cpu, bool idle)
+{
+	s32 sibling = cctx->smt_sibling;
+
+	if (sibling < 0) {
+		/* No sibling: the whole core is just this CPU */
+		idle_mask_update(&ccd_core_idle_masks, cctx->ccd, cpu, idle);
+		return;
+	}
+
+	if (!idle) {
+		idle_mask_update(&ccd_core_idle_masks, cctx->ccd, cpu, false);
+		idle_mask_update(&ccd_core_idle_masks, cctx->ccd, sibling, false);
+		return;
+	}
+
+	if (cpu_in_mask(&ccd_idle_masks, cctx->ccd, sibling)) {
+		idle_mask_update(&ccd_core_idle_masks, cctx->ccd, cpu, true);
+		idle_mask_update(&ccd_core_idle_masks, cctx->ccd, sibling, true);
+	}
+}
+
+/*
+ * Update all idle masks covering @cpu (CCD, NUMA node, core type)
+ */
+static void update_idle_masks(s32 cpu, bool idle)
+{
+	struct cpu_ctx *cctx;
+
+	cctx = get_cpu_ctx(cpu);
+	if (!cctx)
+		return;
+
+	if (cctx->ccd < MAX_CCDS) {
+		idle_mask_update(&ccd_idle_masks, cctx->ccd, cpu, idle);
+		if (smt_enabled)
+			update_core_idle_mask(cctx, cpu, idle);
+	}
+	if (cctx->node < MAX_NUMA_NODES)
+		idle_mask_update(&node_idle_masks, cctx->node, cpu, idle);
+	if (is_intel_hybrid)
+		idle_mask_update(&core_type_idle_masks,
+				 cctx->is_pcore ? CORE_TYPE_PCORE : CORE_TYPE_ECORE,
+				 cpu, idle);
+}
+
+/*
+ * Update the per-CCD victim index for @cpu's current priority class.
+ *
+ * Each CPU runs at most one task, so membership in the two class masks is
+ * mutually exclusive: set the bit in the mask matching @prio (if running)
+ * and clear it from the other.
+ */
+static void update_victim_masks(s32 cpu, u32 ccd, u32 prio, bool running)
+{
+	if (ccd >= MAX_CCDS)
+		return;
+
+	idle_mask_update(&ccd_batch_run_masks, ccd, cpu,
+			 running && prio == PRIO_BATCH);
+	idle_mask_update(&ccd_interactive_run_masks, ccd, cpu,
+			 running && prio == PRIO_INTERACTIVE);
+}
+
+/*
+ * Pick and claim an idle CPU from a maintained idle mask, restricted to the
+ * task's allowed CPUs. Returns the claimed CPU or -1 (caller falls back to
+ * the linear scan).
+ */
+static s32 pick_idle_from_mask(struct task_struct *p, void *map, u32 idx)
+{
+	struct idle_cpumask_wrapper *wrap;
+	struct bpf_cpumask *mask;
+	s32 cpu = -1;
+
+	wrap = bpf_map_lookup_elem(map, &idx);
+	if (!wrap)
+		return -1;
+
+	bpf_rcu_read_lock();
+	mask = wrap->mask;
+	if (mask)
+		cpu = bpf_cpumask_any_and_distribute(cast_mask(mask), p->cpus_ptr);
+	bpf_rcu_read_unlock();
+
+	if (cpu < 0 || (u32)cpu >= nr_cpus_possible)
+		return -1;
+
+	if (scx_bpf_test_and_clear_cpu_idle(cpu)) {
+		__sync_fetch_and_add(&nr_idle_mask_picks, 1);
+		return cpu;
+	}
+
+	return -1;
+}
+
 /*
  * v0.3.0: SMT Contention Detection
  *
@@ -937,6 +1814,30 @@ static bool is_smt_contended(s32 cpu)
 	return stctx->burst_time > (get_burst_threshold() * 2);
 }
 
+/*
+ * SMT isolation: is @cpu the sibling of a CPU currently running a
+ * PRIO_GAMING task? Batch tasks are kept off such CPUs entirely - sharing
+ * a physical core's frontend with a game thread costs measurable
+ * frame-time on Zen 4. O(1) via the maintained cpu_run_states.
+ */
+static bool sibling_runs_gaming(s32 cpu)
+{
+	struct cpu_ctx *cctx;
+	struct cpu_run_state *state;
+	u32 key;
+
+	if (!smt_isolation || !smt_enabled)
+		return false;
+
+	cctx = get_cpu_ctx(cpu);
+	if (!cctx || cctx->smt_sibling < 0)
+		return false;
+
+	key = cctx->smt_sibling;
+	state = bpf_map_lookup_elem(&cpu_run_states, &key);
+	return state && state->pid && state->priority_class == PRIO_GAMING;
+}
+
 /*
  * Helper: Pick idle CPU from a specific CCD with SMT awareness
  *
@@ -950,25 +1851,53 @@ static bool is_smt_contended(s32 cpu)
 static s32 pick_idle_cpu_in_ccd(struct task_struct *p, u32 target_ccd, bool prefer_smt_idle)
 {
 	const struct cpumask *idle_smtmask = NULL;
+	struct task_ctx *tctx;
 	struct cpu_ctx *cctx;
 	s32 cpu, best_cpu = -1;
 	u32 best_ranking = 0;
+	bool avoid_gaming_siblings = false;
 
 	if (target_ccd >= nr_ccds)
 		return -1;
 
-	/* Get SMT-idle mask if we prefer full-idle cores */
-	if (prefer_smt_idle && smt_enabled)
+	/*
+	 * SMT isolation: while gaming threads run in this CCD, keep batch
+	 * tasks off their siblings. The blind mask pick below can't express
+	 * the exclusion, so fall through to the scan which applies it per
+	 * candidate. CCDs without running games (the common case) keep the
+	 * fast path.
+	 */
+	if (smt_isolation && smt_enabled) {
+		tctx = get_task_ctx(p);
+		if (!tctx || (!tctx->is_gaming && !tctx->is_interactive)) {
+			u32 lkey = target_ccd;
+			struct ccd_load *load =
+				bpf_map_lookup_elem(&ccd_loads, &lkey);
+
+			avoid_gaming_siblings = load && load->nr_gaming > 0;
+		}
+	}
+
+	if (prefer_smt_idle && smt_enabled) {
+		/*
+		 * Fast path: claim a whole-idle physical core with a single
+		 * pick from the maintained core-idle mask.
+		 */
+		cpu = pick_idle_from_mask(p, &ccd_core_idle_masks, target_ccd);
+		if (cpu >= 0) {
+			__sync_fetch_and_add(&nr_smt_idle_picks, 1);
+			return cpu;
+		}
+
+		/* Slow path: scan against the kernel's SMT-idle mask */
 		idle_smtmask = scx_bpf_get_idle_smtmask();
+	}
 
 	/*
 	 * First pass: find SMT-idle CPUs, preferring highest prefcore ranking
 	 */
 	if (idle_smtmask) {
-		bpf_for(cpu, 0, nr_cpus_possible) {
-			if (cpu >= MAX_CPUS)
-				break;
-
+		for (cpu = 0; cpu < (s32)nr_cpus_possible && cpu < MAX_CPUS; cpu++) {
 			cctx = get_cpu_ctx(cpu);
 			if (!cctx || cctx->ccd != target_ccd)
 				continue;
@@ -1002,6 +1931,16 @@ static s32 pick_idle_cpu_in_ccd(struct task_struct *p, u32 target_ccd, bool pref
 		scx_bpf_put_idle_cpumask(idle_smtmask);
 	}
 
+	/*
+	 * Fast path: claim any idle CPU in the CCD from the maintained idle
+	 * mask with a single cpumask op instead of scanning every CPU.
+	 */
+	if (!avoid_gaming_siblings) {
+		cpu = pick_idle_from_mask(p, &ccd_idle_masks, target_ccd);
+		if (cpu >= 0)
+			return cpu;
+	}
+
 	/*
 	 * Second pass: find any idle CPU in the CCD, preferring high prefcore ranking
 	 * v0.3.0: Also prefer non-contended SMT pairs for latency-sensitive tasks
@@ -1011,10 +1950,7 @@ static s32 pick_idle_cpu_in_ccd(struct task_struct *p, u32 target_ccd, bool pref
 	s32 contended_cpu = -1;
 	u32 contended_ranking = 0;
 
-	bpf_for(cpu, 0, nr_cpus_possible) {
-		if (cpu >= MAX_CPUS)
-			break;
-
+	for (cpu = 0; cpu < (s32)nr_cpus_possible && cpu < MAX_CPUS; cpu++) {
 		cctx = get_cpu_ctx(cpu);
 		if (!cctx || cctx->ccd != target_ccd)
 			continue;
@@ -1022,6 +1958,12 @@ static s32 pick_idle_cpu_in_ccd(struct task_struct *p, u32 target_ccd, bool pref
 		if (!bpf_cpumask_test_cpu(cpu, p->cpus_ptr))
 			continue;
 
+		/* Never place batch on the sibling of a running game thread */
+		if (avoid_gaming_siblings && sibling_runs_gaming(cpu)) {
+			__sync_fetch_and_add(&nr_smt_isolations, 1);
+			continue;
+		}
+
 		u32 ranking = get_prefcore_ranking(cpu);
 		bool contended = is_smt_contended(cpu);
 
@@ -1083,10 +2025,7 @@ static s32 pick_idle_pcore(struct task_struct *p, bool prefer_smt_idle)
 	 * First pass: find SMT-idle P-cores
 	 */
 	if (idle_smtmask) {
-		bpf_for(cpu, 0, nr_cpus_possible) {
-			if (cpu >= MAX_CPUS)
-				break;
-
+		for (cpu = 0; cpu < (s32)nr_cpus_possible && cpu < MAX_CPUS; cpu++) {
 			cctx = get_cpu_ctx(cpu);
 			if (!cctx || !cctx->is_pcore)
 				continue;
@@ -1096,7 +2035,7 @@ static s32 pick_idle_pcore(struct task_struct *p, bool prefer_smt_idle)
 
 			/* Check if entire physical core is idle */
 			if (bpf_cpumask_test_cpu(cpu, idle_smtmask)) {
-				u32 ranking = get_prefcore_ranking(cpu);
+				u32 ranking = pcore_ranking(cpu);
 				if (best_cpu < 0 || ranking > best_ranking ||
 				    (ranking == best_ranking && cctx->is_turbo)) {
 					best_cpu = cpu;
@@ -1116,16 +2055,22 @@ static s32 pick_idle_pcore(struct task_struct *p, bool prefer_smt_idle)
 		scx_bpf_put_idle_cpumask(idle_smtmask);
 	}
 
+	/*
+	 * Fast path: claim any idle P-core from the maintained core-type mask
+	 */
+	cpu = pick_idle_from_mask(p, &core_type_idle_masks, CORE_TYPE_PCORE);
+	if (cpu >= 0) {
+		__sync_fetch_and_add(&nr_pcore_placements, 1);
+		return cpu;
+	}
+
 	/*
 	 * Second pass: any idle P-core
 	 */
 	best_cpu = -1;
 	best_ranking = 0;
 
-	bpf_for(cpu, 0, nr_cpus_possible) {
-		if (cpu >= MAX_CPUS)
-			break;
-
+	for (cpu = 0; cpu < (s32)nr_cpus_possible && cpu < MAX_CPUS; cpu++) {
 		cctx = get_cpu_ctx(cpu);
 		if (!cctx || !cctx->is_pcore)
 			continue;
@@ -1133,7 +2078,7 @@ static s32 pick_idle_pcore(struct task_struct *p, bool prefer_smt_idle)
 		if (!bpf_cpumask_test_cpu(cpu, p->cpus_ptr))
 			continue;
 
-		u32 ranking = get_prefcore_ranking(cpu);
+		u32 ranking = pcore_ranking(cpu);
 		if (best_cpu < 0 || ranking > best_ranking ||
 		    (ranking == best_ranking && cctx->is_turbo)) {
 			best_cpu = cpu;
@@ -1159,11 +2104,16 @@ static s32 pick_idle_ecore(struct task_struct *p)
 {
 	struct cpu_ctx *cctx;
 	s32 cpu, best_cpu = -1;
+	u32 best_cap = 0;
 
-	bpf_for(cpu, 0, nr_cpus_possible) {
-		if (cpu >= MAX_CPUS)
-			break;
+	/* Fast path: claim any idle E-core from the maintained core-type mask */
+	cpu = pick_idle_from_mask(p, &core_type_idle_masks, CORE_TYPE_ECORE);
+	if (cpu >= 0) {
+		__sync_fetch_and_add(&nr_ecore_offloads, 1);
+		return cpu;
+	}
 
+	for (cpu = 0; cpu < (s32)nr_cpus_possible && cpu < MAX_CPUS; cpu++) {
 		cctx = get_cpu_ctx(cpu);
 		if (!cctx || cctx->is_pcore)
 			continue;  /* Skip P-cores */
@@ -1171,9 +2121,20 @@ static s32 pick_idle_ecore(struct task_struct *p)
 		if (!bpf_cpumask_test_cpu(cpu, p->cpus_ptr))
 			continue;
 
-		/* E-cores typically don't have SMT, so just find any idle one */
-		if (best_cpu < 0)
+		/*
+		 * E-cores typically don't have SMT; with HFI data prefer the
+		 * most capable E-core cluster, otherwise any idle one
+		 */
+		if (hfi_enabled) {
+			u32 cap = get_hfi_perf_cap(cpu);
+
+			if (best_cpu < 0 || cap > best_cap) {
+				best_cpu = cpu;
+				best_cap = cap;
+			}
+		} else if (best_cpu < 0) {
 			best_cpu = cpu;
+		}
 	}
 
 	if (best_cpu >= 0 && scx_bpf_test_and_clear_cpu_idle(best_cpu)) {
@@ -1204,6 +2165,16 @@ static bool should_use_ecore(struct task_ctx *tctx)
 	if (tctx->is_gaming || tctx->is_interactive)
 		return false;
 
+	/*
+	 * Hardware feedback: a sustained compute burst (AVX-heavy shader
+	 * compile etc.) pays roughly 2x on an E-core. The per-task Thread
+	 * Director class isn't exported to BPF, so treat sustained burst
+	 * time as the signal and keep such threads on P-cores whenever
+	 * userspace publishes live HFI capabilities.
+	 */
+	if (hfi_enabled && tctx->burst_time > get_burst_threshold() * 2)
+		return false;
+
 	if (ecore_offload_mode == 2) {
 		/* Aggressive: offload anything not gaming/interactive */
 		return true;
@@ -1222,41 +2193,127 @@ static struct ccd_load *get_ccd_load(u32 ccd)
 	return bpf_map_lookup_elem(&ccd_loads, &ccd);
 }
 
+/*
+ * Helper: Pick any CPU from a per-CCD victim mask
+ */
+static s32 pick_victim_from_mask(void *map, u32 ccd)
+{
+	struct idle_cpumask_wrapper *wrap;
+	struct bpf_cpumask *mask;
+	s32 cpu = -1;
+
+	wrap = bpf_map_lookup_elem(map, &ccd);
+	if (!wrap)
+		return -1;
+
+	bpf_rcu_read_lock();
+	mask = wrap->mask;
+	if (mask)
+		cpu = (s32)bpf_cpumask_any_distribute(cast_mask(mask));
+	bpf_rcu_read_unlock();
+
+	if (cpu < 0 || (u32)cpu >= nr_cpus_possible)
+		return -1;
+
+	return cpu;
+}
+
 /*
  * Helper: Find a CPU to kick in target CCD for preemption
  *
- * Returns CPU running the lowest priority task that can be preempted.
+ * O(1): picks from the per-CCD victim masks maintained by
+ * ghostbrew_running/ghostbrew_stopping, lowest priority class first.
+ * Returns CPU running a lower-priority task than @min_priority, or -1.
  */
 static s32 find_kick_victim_in_ccd(u32 target_ccd, u32 min_priority)
 {
-	struct cpu_ctx *cctx;
 	struct cpu_run_state *state;
-	s32 victim_cpu = -1;
-	u32 worst_priority = 0;
-	s32 cpu;
+	s32 victim_cpu;
+	u32 key;
 
-	bpf_for(cpu, 0, nr_cpus_possible) {
-		if (cpu >= MAX_CPUS)
-			break;
+	/* Batch tasks are the cheapest victims */
+	victim_cpu = pick_victim_from_mask(&ccd_batch_run_masks, target_ccd);
+	if (victim_cpu < 0 && min_priority < PRIO_INTERACTIVE)
+		victim_cpu = pick_victim_from_mask(&ccd_interactive_run_masks,
+						   target_ccd);
+	if (victim_cpu < 0)
+		return -1;
 
-		cctx = get_cpu_ctx(cpu);
-		if (!cctx || cctx->ccd != target_ccd)
-			continue;
+	/* The masks are advisory - revalidate against the live run state */
+	key = victim_cpu;
+	state = bpf_map_lookup_elem(&cpu_run_states, &key);
+	if (!state || state->priority_class <= min_priority)
+		return -1;
 
-		u32 key = cpu;
-		state = bpf_map_lookup_elem(&cpu_run_states, &key);
-		if (!state)
-			continue;
+	return victim_cpu;
+}
 
-		/* Find CPU running lowest priority task that can be preempted */
-		if (state->priority_class > min_priority &&
-		    state->priority_class >= worst_priority) {
-			worst_priority = state->priority_class;
-			victim_cpu = cpu;
+/*
+ * Proactive CCD load balancer (BPF timer callback)
+ *
+ * Idle-steal in ghostbrew_dispatch only rebalances when a CPU happens to go
+ * idle, and the EVENT_CCD_IMBALANCE path needs a userspace round trip. This
+ * timer inspects the batch-tier backlogs every CCD_BALANCE_INTERVAL_NS and
+ * moves queued batch tasks from the deepest backlog to a CCD with an empty
+ * batch tier, entirely in-kernel. Gaming and V-Cache-bound tasks are never
+ * touched - they live in their own tiers and are skipped explicitly.
+ */
+static int ccd_balance_timerfn(void *map, int *key, struct bpf_timer *timer)
+{
+	u32 src = MAX_CCDS, dst = MAX_CCDS;
+	u64 busiest_backlog = 0;
+	u64 least_running = (u64)-1;
+	u32 moved = 0;
+
+	for (u32 ccd = 0; ccd < nr_ccds && ccd < MAX_CCDS; ccd++) {
+		struct ccd_load *load = get_ccd_load(ccd);
+		u64 queued = scx_bpf_dsq_nr_queued(ccd_prio_dsq(ccd, PRIO_BATCH));
+		u64 running = load ? load->nr_tasks : 0;
+
+		if (queued > busiest_backlog) {
+			busiest_backlog = queued;
+			src = ccd;
+		}
+		if (queued == 0 && running < least_running) {
+			least_running = running;
+			dst = ccd;
 		}
 	}
 
-	return victim_cpu;
+	if (src < MAX_CCDS && dst < MAX_CCDS && src != dst &&
+	    busiest_backlog >= CCD_BALANCE_MIN_BACKLOG) {
+		struct bpf_iter_scx_dsq it;
+		struct task_struct *p;
+		u64 dst_dsq = ccd_prio_dsq(dst, PRIO_BATCH);
+
+		if (!bpf_iter_scx_dsq_new(&it, ccd_prio_dsq(src, PRIO_BATCH), 0)) {
+			while ((p = bpf_iter_scx_dsq_next(&it))) {
+				struct task_ctx *tctx = get_task_ctx(p);
+
+				/* Never migrate gaming or V-Cache-bound tasks */
+				if (tctx && (tctx->is_gaming || tctx->wants_vcache))
+					continue;
+
+				if (scx_bpf_dsq_move_vtime(&it, p, dst_dsq, 0))
+					moved++;
+				if (moved >= CCD_BALANCE_MAX_MIGRATE)
+					break;
+			}
+		}
+		bpf_iter_scx_dsq_destroy(&it);
+
+		if (moved) {
+			__sync_fetch_and_add(&nr_ccd_balance_migrations, moved);
+
+			/* Wake an idle CPU on the target CCD to pick them up */
+			s32 kick = pick_victim_from_mask(&ccd_idle_masks, dst);
+			if (kick >= 0)
+				scx_bpf_kick_cpu(kick, SCX_KICK_IDLE);
+		}
+	}
+
+	bpf_timer_start(timer, CCD_BALANCE_INTERVAL_NS, 0);
+	return 0;
 }
 
 /*
@@ -1287,6 +2344,32 @@ s32 BPF_STRUCT_OPS(ghostbrew_select_cpu, struct task_struct *p,
 	if (!tctx)
 		return prev_cpu;
 
+	/*
+	 * Pinned-task fast path: a task allowed exactly one CPU (pinned QEMU
+	 * vCPUs, taskset users) always ends up on that CPU, so the idle
+	 * search, compaction and hybrid-core branches below are dead work.
+	 * Direct-dispatch to the local DSQ and refresh the classification
+	 * lazily - only when the generation counter says it went stale.
+	 */
+	if (p->nr_cpus_allowed == 1) {
+		if (!tctx->classification_valid ||
+		    tctx->class_gen != classification_gen) {
+			bool gmode = get_gaming_mode();
+
+			tctx->is_gaming = gmode && is_gaming_task(p);
+			tctx->is_interactive =
+				tctx->burst_time < get_burst_threshold();
+			tctx->wants_vcache =
+				tctx->is_gaming ||
+				(tctx->is_interactive && gmode);
+		}
+
+		scx_bpf_dsq_insert(p, SCX_DSQ_LOCAL, get_slice_ns(), 0);
+		__sync_fetch_and_add(&nr_direct_dispatched, 1);
+		__sync_fetch_and_add(&nr_pinned_dispatches, 1);
+		return prev_cpu;
+	}
+
 	prev_cctx = get_cpu_ctx(prev_cpu);
 	if (!prev_cctx)
 		return prev_cpu;
@@ -1297,6 +2380,35 @@ s32 BPF_STRUCT_OPS(ghostbrew_select_cpu, struct task_struct *p,
 	tctx->is_interactive = tctx->burst_time < get_burst_threshold();
 	tctx->wants_vcache = tctx->is_gaming || (tctx->is_interactive && gmode);
 
+	/*
+	 * Demoted busyloop offenders skip the whole idle search - paying
+	 * select_cpu machinery on every 100Hz+ wake is exactly what the
+	 * throttle exists to stop. They ride prev_cpu and drain from the
+	 * shared throttled DSQ whenever a CPU runs out of real work.
+	 */
+	if (tctx->is_throttled && !tctx->is_gaming)
+		return prev_cpu;
+
+	/*
+	 * Weigh measured cache sensitivity over class: a cache-hungry batch
+	 * task gains more from the 96MB L3 than a gaming thread whose
+	 * working set fits anywhere, so the sampled miss ratio can both
+	 * grant and revoke V-Cache affinity. Unmeasured tasks keep the
+	 * class-based verdict.
+	 */
+	u32 score_tgid = BPF_CORE_READ(p, tgid);
+	u32 *cache_score = bpf_map_lookup_elem(&task_cache_scores, &score_tgid);
+	if (cache_score) {
+		if (!tctx->wants_vcache && *cache_score >= CACHE_SCORE_HOT) {
+			tctx->wants_vcache = true;
+			__sync_fetch_and_add(&nr_cache_hot_promotions, 1);
+		} else if (tctx->wants_vcache &&
+			   *cache_score <= CACHE_SCORE_COLD) {
+			tctx->wants_vcache = false;
+			__sync_fetch_and_add(&nr_cache_cold_demotions, 1);
+		}
+	}
+
 	/*
 	 * v0.3.0: Core Compaction / Power Mode
 	 *
@@ -1351,23 +2463,13 @@ s32 BPF_STRUCT_OPS(ghostbrew_select_cpu, struct task_struct *p,
 	 */
 	u32 pid = p->pid;
 	u32 *numa_pref = bpf_map_lookup_elem(&numa_hints, &pid);
-	if (numa_pref && *numa_pref < 255) {
-		u32 target_node = *numa_pref;
-
-		/* Try to find idle CPU in the target NUMA node */
-		for (u32 c = 0; c < nr_cpus_possible && c < MAX_CPUS; c++) {
-			if (!bpf_cpumask_test_cpu(c, p->cpus_ptr))
-				continue;
-
-			struct cpu_ctx *cctx = get_cpu_ctx(c);
-			if (!cctx || cctx->node != target_node)
-				continue;
-
-			if (scx_bpf_test_and_clear_cpu_idle(c)) {
-				scx_bpf_dsq_insert(p, SCX_DSQ_LOCAL, get_slice_ns(), 0);
-				__sync_fetch_and_add(&nr_direct_dispatched, 1);
-				return c;
-			}
+	if (numa_pref && *numa_pref < 255 && *numa_pref < MAX_NUMA_NODES) {
+		/* Claim an idle CPU in the target node via the maintained mask */
+		cpu = pick_idle_from_mask(p, &node_idle_masks, *numa_pref);
+		if (cpu >= 0) {
+			scx_bpf_dsq_insert(p, SCX_DSQ_LOCAL, get_slice_ns(), 0);
+			__sync_fetch_and_add(&nr_direct_dispatched, 1);
+			return cpu;
 		}
 		/* No idle CPU in preferred NUMA node, fall through */
 	}
@@ -1543,6 +2645,10 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 	struct percpu_stats *pstats;
 	u64 vtime = 0;
 	u64 dsq_id = FALLBACK_DSQ;
+	u64 slice = get_slice_ns();
+	u32 target_ccd = MAX_CCDS;
+	u32 prio = PRIO_BATCH;
+	bool throttled = false;
 	s32 cpu, kick_cpu;
 
 	__sync_fetch_and_add(&nr_enqueued, 1);
@@ -1566,18 +2672,31 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 		if (enq_flags & SCX_ENQ_WAKEUP) {
 			if (tctx->last_wakeup_at > 0) {
 				u64 delta = now - tctx->last_wakeup_at;
+				u64 avg = tctx->avg_wakeup_interval;
+
+				/*
+				 * Stability tracking for frame pacing: count
+				 * consecutive wakeups within +/-25% of the
+				 * EWMA period. A render thread pacing at a
+				 * fixed frame rate converges here quickly.
+				 */
+				if (avg > 0 && delta > (avg - avg / 4) &&
+				    delta < (avg + avg / 4))
+					tctx->stable_wakeups++;
+				else
+					tctx->stable_wakeups = 0;
 
 				/* EWMA: avg = (7 * avg + delta) / 8 */
-				if (tctx->avg_wakeup_interval == 0)
+				if (avg == 0)
 					tctx->avg_wakeup_interval = delta;
 				else
 					tctx->avg_wakeup_interval =
-						(7 * tctx->avg_wakeup_interval + delta) >> 3;
+						(7 * avg + delta) >> 3;
 
-				/* Calculate frequency (capped at 100Hz) */
+				/* Calculate frequency (capped at 1000Hz) */
 				if (tctx->avg_wakeup_interval > 0) {
 					u64 freq = NSEC_PER_SEC / tctx->avg_wakeup_interval;
-					tctx->wakeup_freq_hz = freq > 100 ? 100 : (u32)freq;
+					tctx->wakeup_freq_hz = freq > 1000 ? 1000 : (u32)freq;
 
 					/* Track high-frequency wakers */
 					if (tctx->wakeup_freq_hz > 50 && !tctx->is_gaming)
@@ -1585,19 +2704,45 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 				}
 			}
 			tctx->last_wakeup_at = now;
+
+			/*
+			 * Busyloop throttling verdict. A sustained streak of
+			 * high-frequency, tiny-burst wakeups from a non-gaming
+			 * task demotes it to the throttled DSQ; the moment the
+			 * behavior changes (frequency drops under the exit
+			 * threshold, bursts grow, or it turns out to be a
+			 * game) it is promoted straight back.
+			 */
+			if (!tctx->is_gaming &&
+			    tctx->wakeup_freq_hz >= BUSYLOOP_MIN_FREQ_HZ &&
+			    tctx->burst_time < BUSYLOOP_MAX_BURST_NS) {
+				if (tctx->busyloop_streak < BUSYLOOP_DEMOTE_WAKEUPS)
+					tctx->busyloop_streak++;
+				if (!tctx->is_throttled &&
+				    tctx->busyloop_streak >= BUSYLOOP_DEMOTE_WAKEUPS) {
+					tctx->is_throttled = true;
+					__sync_fetch_and_add(&nr_busyloop_demotions, 1);
+				}
+			} else if (tctx->is_gaming ||
+				   tctx->wakeup_freq_hz <= BUSYLOOP_EXIT_FREQ_HZ ||
+				   tctx->burst_time >= BUSYLOOP_MAX_BURST_NS) {
+				tctx->busyloop_streak = 0;
+				if (tctx->is_throttled) {
+					tctx->is_throttled = false;
+					__sync_fetch_and_add(&nr_busyloop_promotions, 1);
+				}
+			}
 		}
 	}
 
-	/* Determine target CCD DSQ */
+	/* Determine target CCD */
 	cpu = scx_bpf_task_cpu(p);
 	cctx = get_cpu_ctx(cpu);
 	if (cctx) {
-		/* Use CCD-specific DSQ */
-		if (tctx && tctx->wants_vcache) {
-			dsq_id = ccd_to_dsq(vcache_ccd);
-		} else {
-			dsq_id = ccd_to_dsq(cctx->ccd);
-		}
+		if (tctx && tctx->wants_vcache)
+			target_ccd = vcache_ccd;
+		else
+			target_ccd = cctx->ccd;
 
 		/* Track which CCD the task is on */
 		if (tctx)
@@ -1607,14 +2752,54 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 	if (tctx) {
 		/* BORE-style priority: lower vtime = higher priority */
 		if (tctx->is_gaming) {
+			prio = PRIO_GAMING;
 			vtime = 0;  /* Highest priority for gaming */
 			__sync_fetch_and_add(&nr_gaming_tasks, 1);
 
+			/*
+			 * Frame pacing: for a render thread with a stable
+			 * 30-360Hz wakeup period, the wakeup frequency is the
+			 * frame rate. Order it by deadline slack within the
+			 * gaming tier (deadline = last_wakeup + period) and
+			 * grant a slice running to that deadline instead of
+			 * the flat default, so e.g. a 144Hz render thread
+			 * sharing a CCD with interactive tasks is never cut
+			 * off mid-frame.
+			 */
+			if (tctx->wakeup_freq_hz >= FRAME_PACE_MIN_HZ &&
+			    tctx->wakeup_freq_hz <= FRAME_PACE_MAX_HZ &&
+			    tctx->stable_wakeups >= FRAME_PACE_MIN_STABLE &&
+			    tctx->avg_wakeup_interval > 0) {
+				u64 period = tctx->avg_wakeup_interval;
+				u64 deadline = tctx->last_wakeup_at + period;
+				u64 fp_now = tctx->enqueue_at;
+				u64 slack = deadline > fp_now ?
+					    deadline - fp_now : 0;
+
+				/* Earliest deadline dispatches first */
+				vtime = slack;
+
+				/* Run up to the deadline, at most one period */
+				slice = slack;
+				if (slice < get_slice_ns())
+					slice = get_slice_ns();
+				if (slice > period)
+					slice = period;
+
+				__sync_fetch_and_add(&nr_frame_paced, 1);
+			}
+
 			/*
 			 * Kick preemption: if gaming task needs V-Cache CCD,
-			 * find a lower-priority task to preempt.
+			 * find a lower-priority task to preempt. Skipped while
+			 * the game is GPU-bound - the render pipeline is
+			 * waiting on the GPU, so evicting a batch task buys no
+			 * frame time and just costs its throughput.
 			 */
-			if (tctx->wants_vcache) {
+			if (tctx->wants_vcache &&
+			    get_gpu_bound_mode() == GPU_MODE_GPU_BOUND) {
+				__sync_fetch_and_add(&nr_gpu_relaxed_kicks, 1);
+			} else if (tctx->wants_vcache) {
 				kick_cpu = find_kick_victim_in_ccd(vcache_ccd, PRIO_GAMING);
 				if (kick_cpu >= 0) {
 					scx_bpf_kick_cpu(kick_cpu, SCX_KICK_PREEMPT);
@@ -1632,7 +2817,21 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 			/* Update percpu gaming stats */
 			if (pstats)
 				pstats->gaming_tasks++;
+		} else if (tctx->is_throttled) {
+			/*
+			 * Demoted busyloop offender: shared throttled DSQ
+			 * (drained after every priority tier) with a wide
+			 * slice, so its wakes batch up instead of each one
+			 * cutting into real work. Ordered by wakeup rate so
+			 * the worst spinners wait the longest. Overrides the
+			 * interactive classification its tiny bursts earn it.
+			 */
+			throttled = true;
+			vtime = tctx->burst_time / 100 +
+				(u64)tctx->wakeup_freq_hz * 1000;
+			slice *= BUSYLOOP_SLICE_MULT;
 		} else if (tctx->is_interactive) {
+			prio = PRIO_INTERACTIVE;
 			vtime = tctx->burst_time / 1000;
 			__sync_fetch_and_add(&nr_interactive_tasks, 1);
 		} else {
@@ -1647,6 +2846,23 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 				vtime += (u64)tctx->wakeup_freq_hz * 1000;
 				__sync_fetch_and_add(&nr_wakeup_penalties, 1);
 			}
+
+			/*
+			 * GPU-bound games leave CPU headroom; grant batch
+			 * longer slices to reclaim throughput while latency
+			 * doesn't matter.
+			 */
+			if (get_gpu_bound_mode() == GPU_MODE_GPU_BOUND)
+				slice *= 2;
+
+			/*
+			 * Proportional share across cgroups: order batch
+			 * tasks by their cgroup's weight-scaled vruntime so
+			 * a thread-rich low-weight container cannot
+			 * out-schedule a small high-weight service by sheer
+			 * thread count.
+			 */
+			vtime += cgroup_vtime_penalty(p);
 		}
 
 		/*
@@ -1657,9 +2873,39 @@ void BPF_STRUCT_OPS(ghostbrew_enqueue, struct task_struct *p, u64 enq_flags)
 		if ((tctx->flags & TASK_FLAG_FUTEX_HOLDER) && vtime > 0) {
 			vtime = vtime >> 1;  /* 2x priority boost */
 		}
+
+		/*
+		 * Priority inheritance: a gaming waiter is blocked on a futex
+		 * this task holds (see ghostbrew_futex_wait_entry). Promote
+		 * it out of the batch tier and to the front of its vtime
+		 * order so the lock is handed off within one dispatch cycle
+		 * instead of after the whole batch backlog drains.
+		 */
+		if (tctx->flags & TASK_FLAG_PI_BOOSTED) {
+			if (prio > PRIO_INTERACTIVE)
+				prio = PRIO_INTERACTIVE;
+			vtime = vtime >> 2;
+			/* A gaming waiter needs this lock handed off now */
+			throttled = false;
+		}
 	}
 
-	scx_bpf_dsq_insert_vtime(p, dsq_id, get_slice_ns(), vtime, enq_flags);
+	/* Queue on the target CCD's tier for this priority class */
+	if (throttled)
+		dsq_id = THROTTLED_DSQ;
+	else if (target_ccd < MAX_CCDS)
+		dsq_id = ccd_prio_dsq(target_ccd, prio);
+
+	/*
+	 * Remember which CCD's DSQ holds the task so ops.running can
+	 * recognize a cross-CCD steal (shared DSQs don't count).
+	 */
+	if (tctx)
+		tctx->enqueue_ccd = (dsq_id >= CCD_DSQ_BASE &&
+				     dsq_id < THROTTLED_DSQ) ? target_ccd : MAX_CCDS;
+
+	scx_bpf_dsq_insert_vtime(p, dsq_id, slice, vtime, enq_flags);
+	dsq_depth_note(dsq_id);
 }
 
 /*
@@ -1669,7 +2915,6 @@ void BPF_STRUCT_OPS(ghostbrew_dispatch, s32 cpu, struct task_struct *prev)
 {
 	struct cpu_ctx *cctx;
 	struct percpu_stats *pstats;
-	u64 local_dsq;
 
 	/* Update percpu dispatch stats */
 	pstats = get_percpu_stats();
@@ -1684,36 +2929,64 @@ void BPF_STRUCT_OPS(ghostbrew_dispatch, s32 cpu, struct task_struct *prev)
 		return;
 	}
 
-	/* First try local CCD's DSQ */
-	local_dsq = ccd_to_dsq(cctx->ccd);
-	if (scx_bpf_dsq_move_to_local(local_dsq)) {
-		__sync_fetch_and_add(&nr_dispatched, 1);
-		return;
-	}
+	/*
+	 * SMT isolation: while our sibling runs a gaming thread, refuse to
+	 * pull batch work onto this CPU - it would contend for the shared
+	 * core frontend. Higher tiers (and the fallback DSQ, which holds
+	 * affinity-restricted tasks) still dispatch normally.
+	 */
+	bool skip_batch = sibling_runs_gaming(cpu);
 
-	/* For V-Cache CPUs, also check V-Cache DSQ specifically */
-	if (cctx->is_vcache) {
-		u64 vcache_dsq = ccd_to_dsq(vcache_ccd);
-		if (vcache_dsq != local_dsq && scx_bpf_dsq_move_to_local(vcache_dsq)) {
+	/* First drain the local CCD's tiers in strict priority order */
+	for (u32 prio = 0; prio < NR_PRIO_TIERS; prio++) {
+		if (skip_batch && prio == PRIO_BATCH)
+			continue;
+		if (scx_bpf_dsq_move_to_local(ccd_prio_dsq(cctx->ccd, prio))) {
 			__sync_fetch_and_add(&nr_dispatched, 1);
+			dsq_depth_note(ccd_prio_dsq(cctx->ccd, prio));
 			return;
 		}
 	}
 
-	/* Try other CCD DSQs */
-	for (u32 i = 0; i < nr_ccds && i < MAX_CCDS; i++) {
-		u64 dsq_id = ccd_to_dsq(i);
-		if (dsq_id == local_dsq)
+	/* For V-Cache CPUs, also check the V-Cache CCD's tiers specifically */
+	if (is_x3d && cctx->is_vcache && vcache_ccd != cctx->ccd) {
+		for (u32 prio = 0; prio < NR_PRIO_TIERS; prio++) {
+			if (skip_batch && prio == PRIO_BATCH)
+				continue;
+			if (scx_bpf_dsq_move_to_local(ccd_prio_dsq(vcache_ccd, prio))) {
+				__sync_fetch_and_add(&nr_dispatched, 1);
+				dsq_depth_note(ccd_prio_dsq(vcache_ccd, prio));
+				return;
+			}
+		}
+	}
+
+	/* Steal from other CCDs, higher priority tiers first */
+	for (u32 prio = 0; prio < NR_PRIO_TIERS; prio++) {
+		if (skip_batch && prio == PRIO_BATCH)
 			continue;
-		if (scx_bpf_dsq_move_to_local(dsq_id)) {
-			__sync_fetch_and_add(&nr_dispatched, 1);
-			return;
+		for (u32 i = 0; i < nr_ccds && i < MAX_CCDS; i++) {
+			if (i == cctx->ccd)
+				continue;
+			if (scx_bpf_dsq_move_to_local(ccd_prio_dsq(i, prio))) {
+				__sync_fetch_and_add(&nr_dispatched, 1);
+				dsq_depth_note(ccd_prio_dsq(i, prio));
+				return;
+			}
 		}
 	}
 
-	/* Finally try fallback DSQ */
+	/*
+	 * Finally the fallback DSQ, then the throttled busyloop DSQ - its
+	 * tasks only run once every tier of real work is drained, which
+	 * together with their widened slices batches their wakes.
+	 */
 	if (scx_bpf_dsq_move_to_local(FALLBACK_DSQ)) {
 		__sync_fetch_and_add(&nr_dispatched, 1);
+		dsq_depth_note(FALLBACK_DSQ);
+	} else if (scx_bpf_dsq_move_to_local(THROTTLED_DSQ)) {
+		__sync_fetch_and_add(&nr_dispatched, 1);
+		dsq_depth_note(THROTTLED_DSQ);
 	}
 
 	/*
@@ -1725,11 +2998,11 @@ void BPF_STRUCT_OPS(ghostbrew_dispatch, s32 cpu, struct task_struct *prev)
 	 */
 	if (get_tickless_enabled() && prev && !(prev->flags & PF_IDLE)) {
 		/* Check if any DSQs have waiting tasks */
-		bool has_waiting = false;
-		if (scx_bpf_dsq_nr_queued(local_dsq) > 0)
-			has_waiting = true;
+		bool has_waiting = ccd_has_queued(cctx->ccd);
 		if (!has_waiting && scx_bpf_dsq_nr_queued(FALLBACK_DSQ) > 0)
 			has_waiting = true;
+		if (!has_waiting && scx_bpf_dsq_nr_queued(THROTTLED_DSQ) > 0)
+			has_waiting = true;
 
 		/* Grant infinite slice if no contention */
 		if (!has_waiting) {
@@ -1806,10 +3079,49 @@ void BPF_STRUCT_OPS(ghostbrew_running, struct task_struct *p)
 						   NULL);
 				}
 
-				/* v0.3.0: Record to latency histogram for percentile tracking */
+			}
+
+			/* Per-CPU, per-class histogram - no cross-core atomics */
+			struct latency_hists *lh = get_latency_hists();
+			if (lh) {
+				u32 hprio = tctx->is_gaming ? PRIO_GAMING :
+					    tctx->is_interactive ? PRIO_INTERACTIVE :
+					    PRIO_BATCH;
 				u32 bucket = latency_to_bucket(latency);
-				if (bucket < HIST_BUCKETS)
-					__sync_fetch_and_add(&gaming_latency_hist[bucket], 1);
+
+				if (hprio < NR_PRIO_TIERS && bucket < HIST_BUCKETS)
+					lh->hist[hprio][bucket]++;
+			}
+
+			/*
+			 * Cross-CCD steal accounting. The dispatch steal
+			 * loop moves tasks with scx_bpf_dsq_move_to_local(),
+			 * which yields no task handle, so the steal is
+			 * recognized here instead: the task runs on a
+			 * different CCD than the DSQ it was queued on. The
+			 * latency just computed is exactly the stolen
+			 * task's queue age.
+			 */
+			if (tctx->enqueue_ccd < MAX_CCDS) {
+				struct cpu_ctx *run_cctx =
+					get_cpu_ctx(scx_bpf_task_cpu(p));
+
+				if (run_cctx &&
+				    run_cctx->ccd != tctx->enqueue_ccd &&
+				    run_cctx->ccd < MAX_CCDS) {
+					struct steal_stats *ss = get_steal_stats();
+					u32 sccd = run_cctx->ccd;
+					u32 bucket = latency_to_bucket(latency);
+
+					if (ss && sccd < MAX_CCDS) {
+						ss->nr_steals[sccd]++;
+						ss->age_sum_ns[sccd] += latency;
+						if (latency > ss->age_max_ns[sccd])
+							ss->age_max_ns[sccd] = latency;
+						if (bucket < HIST_BUCKETS)
+							ss->age_hist[bucket]++;
+					}
+				}
 			}
 
 			/* Reset enqueue_at to avoid double counting */
@@ -1819,6 +3131,9 @@ void BPF_STRUCT_OPS(ghostbrew_running, struct task_struct *p)
 
 	cpu = scx_bpf_task_cpu(p);
 
+	/* CPU is now busy - drop it from the maintained idle masks */
+	update_idle_masks(cpu, false);
+
 	/* Update CPU performance state (track when CPU became busy) */
 	perf_state = get_cpu_perf_state(cpu);
 	if (perf_state) {
@@ -1856,6 +3171,9 @@ void BPF_STRUCT_OPS(ghostbrew_running, struct task_struct *p)
 			state->priority_class = PRIO_INTERACTIVE;
 		else
 			state->priority_class = PRIO_BATCH;
+
+		/* Keep the O(1) preemption victim index in sync */
+		update_victim_masks(cpu, cctx->ccd, state->priority_class, true);
 	}
 }
 
@@ -1884,6 +3202,15 @@ void BPF_STRUCT_OPS(ghostbrew_stopping, struct task_struct *p, bool runnable)
 	if (tctx && tctx->is_gaming && runnable)
 		__sync_fetch_and_add(&gaming_preempted, 1);
 
+	/*
+	 * The PI boost is transient: once the promoted holder has run and
+	 * gone back to sleep it either released the lock (futex_wake also
+	 * clears the flag) or will be re-boosted by the next blocked gaming
+	 * waiter. Keep it across preemptions while still runnable.
+	 */
+	if (tctx && (tctx->flags & TASK_FLAG_PI_BOOSTED) && !runnable)
+		tctx->flags &= ~TASK_FLAG_PI_BOOSTED;
+
 	/* Update burst tracking */
 	if (tctx && tctx->last_run_at > 0) {
 		delta = now - tctx->last_run_at;
@@ -1895,6 +3222,14 @@ void BPF_STRUCT_OPS(ghostbrew_stopping, struct task_struct *p, bool runnable)
 			/* Sleeping - reset burst time */
 			tctx->burst_time = 0;
 		}
+
+		/*
+		 * Charge batch runtime to the cgroup's shared vruntime.
+		 * Gaming/interactive tiers are ordered by latency, not
+		 * share, and stay exempt on both sides.
+		 */
+		if (!tctx->is_gaming && !tctx->is_interactive)
+			charge_cgroup_vtime(p, delta);
 	}
 
 	/* Update per-CCD load */
@@ -1925,10 +3260,67 @@ void BPF_STRUCT_OPS(ghostbrew_stopping, struct task_struct *p, bool runnable)
 		state->pid = 0;
 	}
 
+	/* CPU no longer runs a preemptible victim */
+	if (cctx)
+		update_victim_masks(cpu, cctx->ccd, PRIO_GAMING, false);
+
 	/* Mark CPU as potentially idle (will be updated when next task runs) */
 	perf_state = get_cpu_perf_state(cpu);
 	if (perf_state)
 		perf_state->last_idle_at = now;
+	update_idle_masks(cpu, true);
+}
+
+/*
+ * Publish stats into the arena plane (called from ops.tick)
+ *
+ * Every CPU copies its own percpu_stats slot; CPU 0 additionally publishes
+ * the CCD loads and the gaming latency histogram under a seqcount so
+ * userspace can detect torn multi-word snapshots.
+ */
+static void arena_publish_stats(s32 cpu)
+{
+	struct arena_stats_plane __arena *ast = arena_stats;
+	struct percpu_stats *pstats;
+
+	if (!ast)
+		return;
+	cast_kern(ast);
+
+	pstats = get_percpu_stats();
+	if (pstats && cpu >= 0 && cpu < MAX_CPUS)
+		ast->cpu_stats[cpu] = *pstats;
+
+	if (cpu != 0)
+		return;
+
+	__sync_fetch_and_add(&ast->seq, 1);
+
+	for (u32 i = 0; i < nr_ccds && i < MAX_CCDS; i++) {
+		struct ccd_load *load = get_ccd_load(i);
+		if (load)
+			ast->ccd_loads[i] = *load;
+	}
+	/* Merge the per-CPU gaming histogram rows for the arena copy */
+	{
+		u64 hist_sum[HIST_BUCKETS] = {};
+		u32 key = 0;
+		s32 c;
+
+		bpf_for(c, 0, nr_cpus_possible) {
+			struct latency_hists *lh =
+				bpf_map_lookup_percpu_elem(&latency_hists,
+							   &key, c);
+			if (!lh)
+				continue;
+			for (u32 i = 0; i < HIST_BUCKETS; i++)
+				hist_sum[i] += lh->hist[PRIO_GAMING][i];
+		}
+		for (u32 i = 0; i < HIST_BUCKETS; i++)
+			ast->gaming_latency_hist[i] = hist_sum[i];
+	}
+
+	__sync_fetch_and_add(&ast->seq, 1);
 }
 
 /*
@@ -1951,6 +3343,10 @@ void BPF_STRUCT_OPS(ghostbrew_tick, struct task_struct *p)
 	if (cpu >= MAX_CPUS)
 		return;
 
+	/* Publish stats into the shared arena plane */
+	if (arena_enabled)
+		arena_publish_stats(cpu);
+
 	perf_state = get_cpu_perf_state(cpu);
 	if (!perf_state)
 		return;
@@ -1964,13 +3360,12 @@ void BPF_STRUCT_OPS(ghostbrew_tick, struct task_struct *p)
 	if (get_tickless_enabled() && p && !(p->flags & PF_IDLE)) {
 		struct cpu_ctx *tick_cctx = get_cpu_ctx(cpu);
 		if (tick_cctx && p->scx.slice == SCX_SLICE_INF) {
-			u64 local_dsq = ccd_to_dsq(tick_cctx->ccd);
-			bool has_waiting = false;
+			bool has_waiting = ccd_has_queued(tick_cctx->ccd);
 
-			if (scx_bpf_dsq_nr_queued(local_dsq) > 0)
-				has_waiting = true;
 			if (!has_waiting && scx_bpf_dsq_nr_queued(FALLBACK_DSQ) > 0)
 				has_waiting = true;
+			if (!has_waiting && scx_bpf_dsq_nr_queued(THROTTLED_DSQ) > 0)
+				has_waiting = true;
 
 			if (has_waiting) {
 				/* Force preemption by setting finite slice */
@@ -2073,27 +3468,167 @@ void BPF_STRUCT_OPS(ghostbrew_dump, struct scx_dump_ctx *dctx)
 }
 
 /*
- * ops.init - Initialize scheduler and per-CCD DSQs
+ * Helper: Allocate the bpf_cpumask for one idle-mask map slot
+ */
+static s32 init_idle_mask(void *map, u32 idx)
+{
+	struct idle_cpumask_wrapper *wrap;
+	struct bpf_cpumask *mask, *old;
+
+	wrap = bpf_map_lookup_elem(map, &idx);
+	if (!wrap)
+		return -ENOENT;
+
+	mask = bpf_cpumask_create();
+	if (!mask)
+		return -ENOMEM;
+
+	old = bpf_kptr_xchg(&wrap->mask, mask);
+	if (old)
+		bpf_cpumask_release(old);
+
+	return 0;
+}
+
+/*
+ * ops.init - Initialize scheduler, per-CCD DSQs, and idle cpumasks
  */
 s32 BPF_STRUCT_OPS_SLEEPABLE(ghostbrew_init)
 {
-	s32 ret;
+	s32 cpu, ret;
 
 	/* Create fallback DSQ */
 	ret = scx_bpf_create_dsq(FALLBACK_DSQ, -1);
 	if (ret)
 		return ret;
 
-	/* Create per-CCD DSQs */
+	/* Create per-CCD priority-tier DSQs */
+	for (u32 i = 0; i < nr_ccds && i < MAX_CCDS; i++) {
+		for (u32 prio = 0; prio < NR_PRIO_TIERS; prio++) {
+			ret = scx_bpf_create_dsq(ccd_prio_dsq(i, prio), -1);
+			if (ret)
+				return ret;
+		}
+	}
+
+	/* Shared DSQ for demoted busyloop offenders */
+	ret = scx_bpf_create_dsq(THROTTLED_DSQ, -1);
+	if (ret)
+		return ret;
+
+	/* Allocate maintained idle cpumasks and preemption victim masks */
 	for (u32 i = 0; i < nr_ccds && i < MAX_CCDS; i++) {
-		ret = scx_bpf_create_dsq(ccd_to_dsq(i), -1);
+		ret = init_idle_mask(&ccd_idle_masks, i);
+		if (ret)
+			return ret;
+		if (smt_enabled) {
+			ret = init_idle_mask(&ccd_core_idle_masks, i);
+			if (ret)
+				return ret;
+		}
+		ret = init_idle_mask(&ccd_batch_run_masks, i);
+		if (ret)
+			return ret;
+		ret = init_idle_mask(&ccd_interactive_run_masks, i);
+		if (ret)
+			return ret;
+	}
+	for (u32 i = 0; i < MAX_NUMA_NODES; i++) {
+		ret = init_idle_mask(&node_idle_masks, i);
+		if (ret)
+			return ret;
+	}
+	if (is_intel_hybrid) {
+		ret = init_idle_mask(&core_type_idle_masks, CORE_TYPE_PCORE);
 		if (ret)
 			return ret;
+		ret = init_idle_mask(&core_type_idle_masks, CORE_TYPE_ECORE);
+		if (ret)
+			return ret;
+	}
+
+	/*
+	 * Seed the masks: every CPU starts out idle. cpu_ctxs is populated by
+	 * userspace before the struct_ops link attaches, so topology is valid.
+	 */
+	bpf_for(cpu, 0, nr_cpus_possible)
+		update_idle_masks(cpu, true);
+
+	/* Arm the proactive CCD load balancer (multi-CCD parts only) */
+	if (nr_ccds >= 2) {
+		u32 tkey = 0;
+		struct balance_timer *bt;
+
+		bt = bpf_map_lookup_elem(&balance_timer_map, &tkey);
+		if (bt) {
+			bpf_timer_init(&bt->timer, &balance_timer_map,
+				       CLOCK_MONOTONIC);
+			bpf_timer_set_callback(&bt->timer, ccd_balance_timerfn);
+			bpf_timer_start(&bt->timer, CCD_BALANCE_INTERVAL_NS, 0);
+		}
+	}
+
+	/* Arm the event aggregation flush timer */
+	{
+		u32 tkey = 0;
+		struct agg_timer *at;
+
+		at = bpf_map_lookup_elem(&agg_timer_map, &tkey);
+		if (at) {
+			bpf_timer_init(&at->timer, &agg_timer_map,
+				       CLOCK_MONOTONIC);
+			bpf_timer_set_callback(&at->timer, agg_flush_timerfn);
+			bpf_timer_start(&at->timer, EVENT_AGG_FLUSH_NS, 0);
+		}
+	}
+
+	/*
+	 * Set up the arena stats plane. The first allocation lands at the
+	 * arena base, so the user-space pointer published below addresses the
+	 * same page in the daemon's mmap of the arena map.
+	 */
+	if (arena_enabled) {
+		struct arena_stats_plane __arena *ast, *uast;
+
+		ast = bpf_arena_alloc_pages(&arena, NULL, ARENA_STATS_PAGES, -1, 0);
+		if (!ast)
+			return -ENOMEM;
+
+		/* Store the raw arena pointer before any address-space casts */
+		arena_stats = ast;
+		uast = ast;
+
+		cast_kern(ast);
+		ast->schema_version = ARENA_SCHEMA_VERSION;
+
+		cast_user(uast);
+		arena_stats_user = (u64)uast;
 	}
 
 	return 0;
 }
 
+/*
+ * ops.init_task - New task entering the scheduler
+ *
+ * task_ctx lives in task-local storage (task_ctxs), so lookups on the hot
+ * paths are a pointer chase off the task_struct rather than a hash probe.
+ * Pre-create the storage here so select_cpu/enqueue never take the
+ * allocation branch inside get_task_ctx on a task's first wakeup.
+ */
+s32 BPF_STRUCT_OPS(ghostbrew_init_task, struct task_struct *p,
+		   struct scx_init_task_args *args)
+{
+	struct task_ctx *tctx;
+
+	tctx = bpf_task_storage_get(&task_ctxs, p, NULL,
+				    BPF_LOCAL_STORAGE_GET_F_CREATE);
+	if (!tctx)
+		return -ENOMEM;
+
+	return 0;
+}
+
 /*
  * ops.exit - Cleanup scheduler
  */
@@ -2128,9 +3663,103 @@ int BPF_PROG(ghostbrew_futex_wait, u32 *uaddr, unsigned int flags,
 
 	tctx = get_task_ctx(p);
 	if (tctx) {
+		struct futex_owner_key key = {
+			.uaddr = (u64)uaddr,
+			.tgid = BPF_CORE_READ(p, tgid),
+			._pad = 0,
+		};
+		u32 pid = p->pid;
+
 		tctx->flags |= TASK_FLAG_FUTEX_HOLDER;
 		__sync_fetch_and_add(&nr_futex_boosts, 1);
+
+		/* Record ownership so blocked gaming waiters can find us */
+		bpf_map_update_elem(&futex_owners, &key, &pid, BPF_ANY);
+	}
+	return 0;
+}
+
+/*
+ * Priority-inheritance fast path: runs when a task is about to block on a
+ * futex. If the waiter is a gaming task and the holder is known (flagged by
+ * the fexit hook above), promote the holder - set TASK_FLAG_PI_BOOSTED so
+ * its next enqueue lands in a higher tier with boosted vtime, and if it is
+ * already sitting in a batch-tier DSQ, requeue it into its CCD's
+ * interactive tier right now and kick an idle CPU to run it. Without this a
+ * gaming thread blocked on a lock held by a descheduled batch task eats the
+ * full lock convoy.
+ */
+SEC("?fentry/__futex_wait")
+int BPF_PROG(ghostbrew_futex_wait_entry, u32 *uaddr, unsigned int flags,
+	     u32 val, struct hrtimer_sleeper *to, u32 bitset)
+{
+	struct task_struct *waiter, *holder;
+	struct task_ctx *wctx, *hctx;
+	struct futex_owner_key key;
+	u32 *owner_pid;
+
+	waiter = bpf_get_current_task_btf();
+	if (!waiter)
+		return 0;
+
+	wctx = get_task_ctx(waiter);
+	if (!wctx || !wctx->is_gaming)
+		return 0;
+
+	/* Only a holder in the waiter's own address space can match */
+	key.uaddr = (u64)uaddr;
+	key.tgid = BPF_CORE_READ(waiter, tgid);
+	key._pad = 0;
+
+	owner_pid = bpf_map_lookup_elem(&futex_owners, &key);
+	if (!owner_pid || *owner_pid == waiter->pid)
+		return 0;
+
+	holder = bpf_task_from_pid(*owner_pid);
+	if (!holder)
+		return 0;
+
+	hctx = get_task_ctx(holder);
+	if (hctx && (hctx->flags & TASK_FLAG_FUTEX_HOLDER) &&
+	    !(hctx->flags & TASK_FLAG_PI_BOOSTED)) {
+		u32 ccd = hctx->last_ccd;
+
+		hctx->flags |= TASK_FLAG_PI_BOOSTED;
+		__sync_fetch_and_add(&nr_futex_pi_boosts, 1);
+
+		/*
+		 * If the holder is queued behind batch work on a non-V-Cache
+		 * CCD, pull it forward instead of waiting for its turn.
+		 */
+		if (ccd < MAX_CCDS && ccd != vcache_ccd) {
+			struct bpf_iter_scx_dsq it;
+			struct task_struct *q;
+			bool moved = false;
+
+			if (!bpf_iter_scx_dsq_new(&it,
+						  ccd_prio_dsq(ccd, PRIO_BATCH),
+						  0)) {
+				while ((q = bpf_iter_scx_dsq_next(&it))) {
+					if (q->pid != holder->pid)
+						continue;
+					if (scx_bpf_dsq_move_vtime(&it, q,
+							ccd_prio_dsq(ccd, PRIO_INTERACTIVE),
+							0))
+						moved = true;
+					break;
+				}
+			}
+			bpf_iter_scx_dsq_destroy(&it);
+
+			if (moved) {
+				s32 kick = pick_victim_from_mask(&ccd_idle_masks, ccd);
+				if (kick >= 0)
+					scx_bpf_kick_cpu(kick, SCX_KICK_IDLE);
+			}
+		}
 	}
+
+	bpf_task_release(holder);
 	return 0;
 }
 
@@ -2150,8 +3779,35 @@ int BPF_PROG(ghostbrew_futex_wake, u32 *uaddr, unsigned int flags,
 		return 0;
 
 	tctx = get_task_ctx(p);
-	if (tctx)
-		tctx->flags &= ~TASK_FLAG_FUTEX_HOLDER;
+	if (tctx) {
+		struct futex_owner_key key = {
+			.uaddr = (u64)uaddr,
+			.tgid = BPF_CORE_READ(p, tgid),
+			._pad = 0,
+		};
+
+		tctx->flags &= ~(TASK_FLAG_FUTEX_HOLDER | TASK_FLAG_PI_BOOSTED);
+		bpf_map_delete_elem(&futex_owners, &key);
+	}
+	return 0;
+}
+
+/*
+ * Process-exec notification for event-driven gaming detection
+ *
+ * Streams newly exec'd PIDs to userspace through the existing events
+ * ringbuf so the daemon only runs its /proc classification for processes
+ * that actually changed, instead of rescanning all of /proc every poll.
+ */
+SEC("tp_btf/sched_process_exec")
+int BPF_PROG(ghostbrew_process_exec, struct task_struct *p, pid_t old_pid,
+	     struct linux_binprm *bprm)
+{
+	char comm[TASK_COMM_LEN];
+
+	BPF_CORE_READ_STR_INTO(&comm, p, comm);
+	emit_event(EVENT_PROC_EXEC, BPF_CORE_READ(p, tgid),
+		   bpf_get_smp_processor_id(), 0, 0, 0, comm);
 	return 0;
 }
 
@@ -2166,6 +3822,7 @@ SCX_OPS_DEFINE(ghostbrew_ops,
 	       .stopping	= (void *)ghostbrew_stopping,
 	       .tick		= (void *)ghostbrew_tick,
 	       .dump		= (void *)ghostbrew_dump,
+	       .init_task	= (void *)ghostbrew_init_task,
 	       .init		= (void *)ghostbrew_init,
 	       .exit		= (void *)ghostbrew_exit,
 	       .timeout_ms	= 5000,
@@ -49,6 +49,9 @@ const VM_PATTERNS: &[&str] = &["machine-qemu", "machine.slice", "libvirt"];
 /// Batch/system cgroup patterns (low priority)
 const BATCH_PATTERNS: &[&str] = &["system.slice", "background.slice"];
 
+/// Default cgroup v2 cpu.weight (matches CGROUP_DEFAULT_WEIGHT in BPF)
+const DEFAULT_CPU_WEIGHT: u32 = 100;
+
 /// Cgroup information with classification
 #[derive(Debug, Clone)]
 pub struct CgroupInfo {
@@ -56,8 +59,10 @@ pub struct CgroupInfo {
     pub path: String,
     /// Cgroup ID (inode number of cgroup directory)
     pub id: u64,
-    /// Classified workload type
+    /// Classified workload type (0 = unclassified, tracked for weight only)
     pub workload_class: u32,
+    /// cgroup v2 cpu.weight (1-10000, DEFAULT_CPU_WEIGHT when absent)
+    pub weight: u32,
 }
 
 /// Get cgroup ID from path (uses inode number as cgroup ID)
@@ -80,6 +85,15 @@ fn get_cgroup_id(path: &Path) -> Option<u64> {
     None
 }
 
+/// Read cgroup v2 cpu.weight (absent on cgroups without the cpu controller)
+fn read_cpu_weight(path: &Path) -> Option<u32> {
+    fs::read_to_string(path.join("cpu.weight"))
+        .ok()?
+        .trim()
+        .parse()
+        .ok()
+}
+
 /// Classify cgroup by its path
 fn classify_cgroup_path(path: &str) -> u32 {
     let path_lower = path.to_lowercase();
@@ -147,13 +161,16 @@ fn scan_cgroup_dir(dir: &Path, relative_path: &str, cgroups: &mut Vec<CgroupInfo
     // Get cgroup ID for this directory
     if let Some(id) = get_cgroup_id(dir) {
         let workload_class = classify_cgroup_path(relative_path);
+        let weight = read_cpu_weight(dir).unwrap_or(DEFAULT_CPU_WEIGHT);
 
-        // Only add if we have a classification
-        if workload_class > 0 {
+        // Track if classified, or if an admin set a non-default cpu.weight
+        // (the BPF side honors weights even on unclassified cgroups)
+        if workload_class > 0 || weight != DEFAULT_CPU_WEIGHT {
             cgroups.push(CgroupInfo {
                 path: relative_path.to_string(),
                 id,
                 workload_class,
+                weight,
             });
         }
     }
@@ -193,6 +210,8 @@ fn scan_cgroup_dir(dir: &Path, relative_path: &str, cgroups: &mut Vec<CgroupInfo
 pub struct CgroupMonitor {
     /// Classified cgroups: cgroup_id -> workload_class
     classifications: HashMap<u64, u32>,
+    /// Scheduling weights: cgroup_id -> cpu.weight (tracked cgroups only)
+    weights: HashMap<u64, u32>,
     /// Path to ID mapping for logging
     path_map: HashMap<u64, String>,
 }
@@ -201,10 +220,14 @@ impl CgroupMonitor {
     pub fn new() -> Result<Self> {
         let cgroups = scan_cgroups()?;
         let mut classifications = HashMap::new();
+        let mut weights = HashMap::new();
         let mut path_map = HashMap::new();
 
         for cg in &cgroups {
-            classifications.insert(cg.id, cg.workload_class);
+            if cg.workload_class > 0 {
+                classifications.insert(cg.id, cg.workload_class);
+            }
+            weights.insert(cg.id, cg.weight);
             path_map.insert(cg.id, cg.path.clone());
         }
 
@@ -241,6 +264,7 @@ impl CgroupMonitor {
 
         Ok(Self {
             classifications,
+            weights,
             path_map,
         })
     }
@@ -250,8 +274,7 @@ impl CgroupMonitor {
         let current = scan_cgroups()?;
 
         let current_ids: std::collections::HashSet<u64> = current.iter().map(|c| c.id).collect();
-        let old_ids: std::collections::HashSet<u64> =
-            self.classifications.keys().copied().collect();
+        let old_ids: std::collections::HashSet<u64> = self.weights.keys().copied().collect();
 
         // Find new cgroups
         let new_cgroups: Vec<CgroupInfo> = current
@@ -265,9 +288,13 @@ impl CgroupMonitor {
 
         // Update internal state
         self.classifications.clear();
+        self.weights.clear();
         self.path_map.clear();
         for cg in &current {
-            self.classifications.insert(cg.id, cg.workload_class);
+            if cg.workload_class > 0 {
+                self.classifications.insert(cg.id, cg.workload_class);
+            }
+            self.weights.insert(cg.id, cg.weight);
             self.path_map.insert(cg.id, cg.path.clone());
         }
 
@@ -292,6 +319,11 @@ impl CgroupMonitor {
         &self.classifications
     }
 
+    /// Get all scheduling weights for populating BPF map
+    pub fn get_weights(&self) -> &HashMap<u64, u32> {
+        &self.weights
+    }
+
     /// Get count of classified cgroups
     pub fn classified_count(&self) -> usize {
         self.classifications.len()
@@ -328,6 +360,7 @@ impl Default for CgroupMonitor {
     fn default() -> Self {
         Self::new().unwrap_or(Self {
             classifications: HashMap::new(),
+            weights: HashMap::new(),
             path_map: HashMap::new(),
         })
     }
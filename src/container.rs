@@ -11,10 +11,11 @@
 // - AI workloads (Ollama, PyTorch, TensorFlow)
 
 use anyhow::Result;
-use log::{debug, info};
+use log::{debug, info, warn};
+use nix::sys::inotify::{AddWatchFlags, InitFlags, Inotify, WatchDescriptor};
 use std::collections::{HashMap, HashSet};
 use std::fs;
-use std::path::Path;
+use std::path::{Path, PathBuf};
 
 /// Container workload classification
 #[derive(Debug, Clone, Copy, PartialEq)]
@@ -37,7 +38,7 @@ impl std::fmt::Display for ContainerWorkloadType {
 }
 
 /// Information about a detected container
-#[derive(Debug)]
+#[derive(Debug, Clone)]
 #[allow(dead_code)]
 pub struct ContainerInfo {
     /// Container ID (short form)
@@ -133,7 +134,7 @@ fn scan_cgroup_dir(dir: &Path, containers: &mut Vec<ContainerInfo>) -> Result<()
             if path.is_dir() {
                 // Skip system cgroups we don't care about
                 let name = entry.file_name().to_string_lossy().to_string();
-                if name == "system.slice" || name == "user.slice" || name == "init.scope" {
+                if is_skipped_cgroup(&name) {
                     continue;
                 }
                 scan_cgroup_dir(&path, containers)?;
@@ -144,6 +145,12 @@ fn scan_cgroup_dir(dir: &Path, containers: &mut Vec<ContainerInfo>) -> Result<()
     Ok(())
 }
 
+/// System cgroups that never hold containers and are excluded from both
+/// scanning and watching
+fn is_skipped_cgroup(name: &str) -> bool {
+    name == "system.slice" || name == "user.slice" || name == "init.scope"
+}
+
 /// Check if a cgroup directory name looks like a container
 fn is_container_cgroup(name: &str) -> bool {
     // Docker format: docker-<id>.scope or <id> under docker/
@@ -362,12 +369,219 @@ pub fn scan_ollama() -> Vec<(u32, String)> {
     ollama_pids
 }
 
+/// Cgroup changes observed since the previous drain
+#[derive(Default)]
+struct CgroupChanges {
+    /// Newly created container scope directories
+    added: Vec<PathBuf>,
+    /// Removed container scope directories
+    removed: Vec<PathBuf>,
+    /// Containers whose population changed (cgroup.events modified)
+    changed: Vec<PathBuf>,
+    /// The kernel event queue overflowed; incremental state is unreliable
+    /// and the caller must fall back to a full rescan
+    overflowed: bool,
+}
+
+/// Inotify watcher over the cgroup2 hierarchy.
+///
+/// Watches every non-container directory the scanner would recurse into for
+/// scope creation/removal, and each container's `cgroup.events` file for
+/// population edges (cgroupfs does not generate inotify events for
+/// `cgroup.procs` writes, but `cgroup.events` is modified whenever the
+/// populated state flips). PID churn inside an already-populated container
+/// is invisible to inotify, so the monitor still runs a low-frequency
+/// reconciliation rescan.
+struct CgroupWatcher {
+    inotify: Inotify,
+    /// Watched parent directories, by descriptor
+    dir_watches: HashMap<WatchDescriptor, PathBuf>,
+    /// Watched per-container cgroup.events files, by descriptor
+    event_watches: HashMap<WatchDescriptor, PathBuf>,
+    /// Reverse index for unwatching removed containers
+    container_wds: HashMap<PathBuf, WatchDescriptor>,
+}
+
+impl CgroupWatcher {
+    fn new() -> Result<Self> {
+        let inotify = Inotify::init(InitFlags::IN_NONBLOCK | InitFlags::IN_CLOEXEC)?;
+        Ok(Self {
+            inotify,
+            dir_watches: HashMap::new(),
+            event_watches: HashMap::new(),
+            container_wds: HashMap::new(),
+        })
+    }
+
+    /// Watch a directory subtree, mirroring scan_cgroup_dir's traversal.
+    /// Per-directory failures are expected (scopes race with us) and only
+    /// logged at debug level.
+    fn watch_tree(&mut self, dir: &Path) {
+        let dir_name = dir
+            .file_name()
+            .map(|n| n.to_string_lossy().to_string())
+            .unwrap_or_default();
+
+        if is_container_cgroup(&dir_name) {
+            self.watch_container(dir);
+            return;
+        }
+
+        self.watch_dir(dir);
+
+        if let Ok(entries) = fs::read_dir(dir) {
+            for entry in entries.flatten() {
+                let path = entry.path();
+                if path.is_dir() {
+                    let name = entry.file_name().to_string_lossy().to_string();
+                    if is_skipped_cgroup(&name) {
+                        continue;
+                    }
+                    self.watch_tree(&path);
+                }
+            }
+        }
+    }
+
+    /// Watch a parent directory for scope creation/removal
+    fn watch_dir(&mut self, dir: &Path) {
+        let flags = AddWatchFlags::IN_CREATE
+            | AddWatchFlags::IN_DELETE
+            | AddWatchFlags::IN_MOVED_FROM
+            | AddWatchFlags::IN_MOVED_TO
+            | AddWatchFlags::IN_ONLYDIR;
+        match self.inotify.add_watch(dir, flags) {
+            Ok(wd) => {
+                self.dir_watches.insert(wd, dir.to_path_buf());
+            }
+            Err(e) => debug!("Failed to watch {:?}: {}", dir, e),
+        }
+    }
+
+    /// Watch a container's cgroup.events for population edges
+    fn watch_container(&mut self, dir: &Path) {
+        let events_path = dir.join("cgroup.events");
+        match self
+            .inotify
+            .add_watch(&events_path, AddWatchFlags::IN_MODIFY)
+        {
+            Ok(wd) => {
+                self.event_watches.insert(wd, dir.to_path_buf());
+                self.container_wds.insert(dir.to_path_buf(), wd);
+            }
+            Err(e) => debug!("Failed to watch {:?}: {}", events_path, e),
+        }
+    }
+
+    /// Drop the watch for a removed container (the kernel usually already
+    /// dropped it and sent IN_IGNORED; rm_watch failure is fine)
+    fn unwatch_container(&mut self, dir: &Path) {
+        if let Some(wd) = self.container_wds.remove(dir) {
+            self.event_watches.remove(&wd);
+            let _ = self.inotify.rm_watch(wd);
+        }
+    }
+
+    /// Drain all pending events into a change set (non-blocking)
+    fn drain(&mut self) -> CgroupChanges {
+        let mut changes = CgroupChanges::default();
+
+        loop {
+            let events = match self.inotify.read_events() {
+                Ok(events) => events,
+                Err(_) => break, // EAGAIN: queue drained
+            };
+
+            for event in events {
+                if event.mask.contains(AddWatchFlags::IN_Q_OVERFLOW) {
+                    changes.overflowed = true;
+                    continue;
+                }
+
+                if event.mask.contains(AddWatchFlags::IN_IGNORED) {
+                    if let Some(dir) = self.event_watches.remove(&event.wd) {
+                        self.container_wds.remove(&dir);
+                    }
+                    self.dir_watches.remove(&event.wd);
+                    continue;
+                }
+
+                if let Some(dir) = self.event_watches.get(&event.wd) {
+                    changes.changed.push(dir.clone());
+                    continue;
+                }
+
+                let Some(parent) = self.dir_watches.get(&event.wd) else {
+                    continue;
+                };
+                let Some(name) = event.name.as_ref().map(|n| n.to_string_lossy().to_string())
+                else {
+                    continue;
+                };
+                if !event.mask.contains(AddWatchFlags::IN_ISDIR) || is_skipped_cgroup(&name) {
+                    continue;
+                }
+                let path = parent.join(&name);
+
+                if event.mask.contains(AddWatchFlags::IN_CREATE)
+                    || event.mask.contains(AddWatchFlags::IN_MOVED_TO)
+                {
+                    if is_container_cgroup(&name) {
+                        self.watch_container(&path);
+                        changes.added.push(path);
+                    } else {
+                        // New intermediate slice: watch it, and pick up any
+                        // scopes created inside before the watch existed
+                        self.watch_tree(&path);
+                        collect_container_dirs(&path, &mut changes.added);
+                    }
+                } else if (event.mask.contains(AddWatchFlags::IN_DELETE)
+                    || event.mask.contains(AddWatchFlags::IN_MOVED_FROM))
+                    && is_container_cgroup(&name)
+                {
+                    changes.removed.push(path);
+                }
+            }
+        }
+
+        changes
+    }
+}
+
+/// Collect container scope directories below `dir` (for slices that appeared
+/// between scan and watch)
+fn collect_container_dirs(dir: &Path, out: &mut Vec<PathBuf>) {
+    if let Ok(entries) = fs::read_dir(dir) {
+        for entry in entries.flatten() {
+            let path = entry.path();
+            if !path.is_dir() {
+                continue;
+            }
+            let name = entry.file_name().to_string_lossy().to_string();
+            if is_container_cgroup(&name) {
+                out.push(path);
+            } else if !is_skipped_cgroup(&name) {
+                collect_container_dirs(&path, out);
+            }
+        }
+    }
+}
+
+/// How many incremental rescans between full reconciliation passes.
+/// Inotify covers scope lifecycle and population edges, but not PID churn
+/// inside a populated container, so periodically resync from a full scan.
+const RECONCILE_INTERVAL: u32 = 60;
+
 /// Container Monitor for tracking containers and their state
 #[allow(dead_code)]
 pub struct ContainerMonitor {
-    containers: Vec<ContainerInfo>,
+    /// Known containers, keyed by cgroup path
+    containers: HashMap<String, ContainerInfo>,
     nvidia_available: bool,
     ollama_pids: Vec<(u32, String)>,
+    /// Incremental change source; None falls back to full rescans
+    watcher: Option<CgroupWatcher>,
+    rescans_since_reconcile: u32,
 }
 
 impl ContainerMonitor {
@@ -398,32 +612,130 @@ impl ContainerMonitor {
             info!("Ollama: {} processes detected", ollama_pids.len());
         }
 
+        // Inotify keeps steady-state polls I/O-free; on failure fall back
+        // to full rescans
+        let watcher = match CgroupWatcher::new() {
+            Ok(mut watcher) => {
+                let base = Path::new("/sys/fs/cgroup");
+                if base.exists() {
+                    watcher.watch_tree(base);
+                }
+                Some(watcher)
+            }
+            Err(e) => {
+                warn!("Cgroup inotify unavailable ({}), using full rescans", e);
+                None
+            }
+        };
+
         Ok(Self {
-            containers,
+            containers: containers
+                .into_iter()
+                .map(|c| (c.cgroup_path.clone(), c))
+                .collect(),
             nvidia_available,
             ollama_pids,
+            watcher,
+            rescans_since_reconcile: 0,
         })
     }
 
-    /// Rescan for containers (call periodically)
+    /// Rescan for containers (call periodically).
+    ///
+    /// With inotify active this only drains pending cgroup events, so a
+    /// steady-state call does no filesystem I/O; a full reconciliation scan
+    /// still runs every RECONCILE_INTERVAL calls to catch PID churn inside
+    /// populated containers (and whenever the event queue overflows).
     pub fn rescan(&mut self) -> Result<(Vec<ContainerInfo>, Vec<String>)> {
+        let Some(watcher) = self.watcher.as_mut() else {
+            return self.full_rescan();
+        };
+        let changes = watcher.drain();
+
+        self.rescans_since_reconcile += 1;
+        if changes.overflowed || self.rescans_since_reconcile >= RECONCILE_INTERVAL {
+            self.rescans_since_reconcile = 0;
+            return self.full_rescan();
+        }
+
+        let mut new_containers = Vec::new();
+        let mut removed_ids = Vec::new();
+
+        for dir in &changes.removed {
+            if let Some(watcher) = self.watcher.as_mut() {
+                watcher.unwatch_container(dir);
+            }
+            let key = dir.to_string_lossy().to_string();
+            if let Some(container) = self.containers.remove(&key) {
+                removed_ids.push(container.id);
+            }
+        }
+
+        // A changed (population edge) container that we don't know yet is
+        // effectively new: it was created empty and just got its first task
+        for dir in changes.added.iter().chain(changes.changed.iter()) {
+            let key = dir.to_string_lossy().to_string();
+            match parse_container_cgroup(dir)? {
+                Some(container) => {
+                    let is_new = !self.containers.contains_key(&key);
+                    if is_new {
+                        new_containers.push(container.clone());
+                    }
+                    self.containers.insert(key, container);
+                }
+                None => {
+                    // Emptied but not yet removed; drop its PIDs now. The
+                    // cgroup.events watch stays for repopulation.
+                    if let Some(container) = self.containers.remove(&key) {
+                        removed_ids.push(container.id);
+                    }
+                }
+            }
+        }
+
+        Ok((new_containers, removed_ids))
+    }
+
+    /// Full cgroup tree rescan (reconciliation and no-inotify fallback)
+    fn full_rescan(&mut self) -> Result<(Vec<ContainerInfo>, Vec<String>)> {
         let current = scan_containers()?;
         self.ollama_pids = scan_ollama();
 
         let current_ids: HashSet<String> = current.iter().map(|c| c.id.clone()).collect();
-        let old_ids: HashSet<String> = self.containers.iter().map(|c| c.id.clone()).collect();
+        let old_ids: HashSet<String> = self.containers.values().map(|c| c.id.clone()).collect();
 
         // Find new containers
         let new_containers: Vec<ContainerInfo> = current
-            .into_iter()
+            .iter()
             .filter(|c| !old_ids.contains(&c.id))
+            .cloned()
             .collect();
 
         // Find removed containers
         let removed_ids: Vec<String> = old_ids.difference(&current_ids).cloned().collect();
 
         // Update container list
-        self.containers = scan_containers()?;
+        self.containers = current
+            .into_iter()
+            .map(|c| (c.cgroup_path.clone(), c))
+            .collect();
+
+        // Rebuild watches from scratch so they match the fresh scan
+        if let Some(watcher) = self.watcher.as_mut() {
+            match CgroupWatcher::new() {
+                Ok(mut fresh) => {
+                    let base = Path::new("/sys/fs/cgroup");
+                    if base.exists() {
+                        fresh.watch_tree(base);
+                    }
+                    *watcher = fresh;
+                }
+                Err(e) => {
+                    warn!("Cgroup inotify lost ({}), using full rescans", e);
+                    self.watcher = None;
+                }
+            }
+        }
 
         Ok((new_containers, removed_ids))
     }
@@ -433,7 +745,7 @@ impl ContainerMonitor {
     pub fn get_container_workloads(&self) -> HashMap<u32, ContainerWorkloadType> {
         let mut workloads = HashMap::new();
 
-        for container in &self.containers {
+        for container in self.containers.values() {
             for &pid in &container.pids {
                 workloads.insert(pid, container.workload_type);
             }
@@ -445,14 +757,14 @@ impl ContainerMonitor {
     /// Get AI container count
     pub fn ai_container_count(&self) -> usize {
         self.containers
-            .iter()
+            .values()
             .filter(|c| c.workload_type == ContainerWorkloadType::Ai)
             .count()
     }
 
     /// Get GPU container count
     pub fn gpu_container_count(&self) -> usize {
-        self.containers.iter().filter(|c| c.has_gpu).count()
+        self.containers.values().filter(|c| c.has_gpu).count()
     }
 
     /// Get total container count
@@ -474,7 +786,7 @@ impl ContainerMonitor {
     /// Get all container PIDs (for BPF map)
     pub fn all_pids(&self) -> Vec<(u32, ContainerWorkloadType)> {
         let mut pids = Vec::new();
-        for container in &self.containers {
+        for container in self.containers.values() {
             for &pid in &container.pids {
                 pids.push((pid, container.workload_type));
             }
@@ -486,9 +798,11 @@ impl ContainerMonitor {
 impl Default for ContainerMonitor {
     fn default() -> Self {
         Self::new().unwrap_or(Self {
-            containers: Vec::new(),
+            containers: HashMap::new(),
             nvidia_available: false,
             ollama_pids: Vec::new(),
+            watcher: None,
+            rescans_since_reconcile: 0,
         })
     }
 }
@@ -5,12 +5,22 @@
 // Provides a simple file-based interface for runtime tuning.
 // Users can write commands to /run/ghostbrew/control to update tunables.
 //
+// Also serves a Unix domain socket (/run/ghostbrew/ghostbrew.sock) with a
+// binary request/response protocol for fleet tooling: tunable pushes are
+// applied on the next 100ms loop tick instead of the stats interval, and
+// GET_STATS returns a fixed-layout snapshot of the scheduler counters,
+// per-CCD loads and the gaming latency histogram without any log parsing.
+//
 // Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
 
 use anyhow::{Context, Result};
 use log::{debug, info, warn};
+use serde::{Deserialize, Serialize};
 use std::fs;
+use std::io::{Read, Write};
+use std::os::unix::net::{UnixListener, UnixStream};
 use std::path::PathBuf;
+use std::time::Duration;
 
 /// Control file commands
 #[derive(Debug, Clone)]
@@ -25,10 +35,181 @@ pub enum ControlCommand {
     WorkMode(bool),
 }
 
+/*
+ * Binary socket protocol
+ *
+ * Request: 9 bytes - opcode (u8) followed by a little-endian u64 argument
+ * (ignored for GET_STATS, 0/1 for the mode opcodes).
+ *
+ * Response: status (u8, 0 = ok), payload length (u32 le), payload bytes.
+ *
+ * GET_STATS payload (all little-endian, fixed layout):
+ *   magic (u32) | version (u32) | nr_ccds (u32) | reserved (u32)
+ *   25 x u64 counters in the order listed in `stats_snapshot` (main.rs)
+ *   16 x u64 gaming latency histogram buckets
+ *   8 x { nr_tasks (u64), nr_gaming (u64) } per-CCD loads
+ *
+ * GET_HANDOFF payload: a JSON-serialized HandoffState. Unlike the stats
+ * snapshot this is variable-length (PID lists, profile names), so it uses
+ * serde_json rather than a fixed layout.
+ */
+pub const OP_SET_BURST_THRESHOLD: u8 = 1;
+pub const OP_SET_SLICE: u8 = 2;
+pub const OP_SET_GAMING_MODE: u8 = 3;
+pub const OP_SET_WORK_MODE: u8 = 4;
+pub const OP_GET_STATS: u8 = 5;
+pub const OP_GET_HANDOFF: u8 = 6;
+
+pub const RESP_OK: u8 = 0;
+pub const RESP_ERR: u8 = 1;
+
+pub const STATS_MAGIC: u32 = 0x4742_5354; // "GBST"
+pub const STATS_VERSION: u32 = 1;
+
+/// Handoff schema version; a mismatch means cold start, never an error
+pub const HANDOFF_VERSION: u32 = 1;
+/// Sanity bound on the handoff payload (PID lists stay far below this)
+const MAX_HANDOFF_PAYLOAD: usize = 1024 * 1024;
+/// The outgoing daemon only accepts on its 100ms loop tick, so the fetch
+/// needs a wider window than the per-client I/O timeout
+const HANDOFF_FETCH_TIMEOUT: Duration = Duration::from_millis(1000);
+
+/// Control socket path (also probed by an incoming daemon for handoff)
+const SOCKET_PATH: &str = "/run/ghostbrew/ghostbrew.sock";
+
+const REQUEST_LEN: usize = 9;
+/// Bound on accepted connections per poll so a chatty client can't starve
+/// the scheduler loop
+const MAX_ACCEPTS_PER_POLL: usize = 16;
+const CLIENT_IO_TIMEOUT: Duration = Duration::from_millis(200);
+
+/// A parsed request from a socket client
+#[derive(Debug)]
+pub enum SocketRequest {
+    /// Tunable push - same commands as the control file
+    Command(ControlCommand),
+    /// Binary stats snapshot query
+    GetStats,
+    /// Warm-handoff state query from an incoming daemon
+    GetHandoff,
+}
+
+/// Userspace state serialized across a warm handoff
+///
+/// An upgrading daemon fetches this from its predecessor over the control
+/// socket and applies it before attaching struct_ops, so classification
+/// (gaming/VM/container PID sets), active profile matches and runtime
+/// tunables survive the restart with no cold start.
+#[derive(Debug, Default, Serialize, Deserialize)]
+pub struct HandoffState {
+    /// Schema version (HANDOFF_VERSION)
+    pub version: u32,
+    /// (pid, workload class) pairs from the gaming detector
+    pub gaming_pids: Vec<(u32, u32)>,
+    /// (pid, workload class) pairs for VM vCPU threads
+    pub vm_pids: Vec<(u32, u32)>,
+    /// (pid, workload class) pairs for container processes
+    pub container_pids: Vec<(u32, u32)>,
+    /// Active game profile matches (pid, profile name)
+    pub active_profiles: Vec<(u32, String)>,
+    /// Raw runtime_tunables map value (burst/slice/modes)
+    pub tunables: Vec<u8>,
+}
+
+/// An accepted client with its parsed request, awaiting a response
+pub struct SocketClient {
+    stream: UnixStream,
+    pub request: SocketRequest,
+}
+
+impl SocketClient {
+    pub fn respond_ok(mut self, payload: &[u8]) {
+        Self::write_response(&mut self.stream, RESP_OK, payload);
+    }
+
+    pub fn respond_err(mut self) {
+        Self::write_response(&mut self.stream, RESP_ERR, &[]);
+    }
+
+    fn write_response(stream: &mut UnixStream, status: u8, payload: &[u8]) {
+        let mut buf = Vec::with_capacity(5 + payload.len());
+        buf.push(status);
+        buf.extend_from_slice(&(payload.len() as u32).to_le_bytes());
+        buf.extend_from_slice(payload);
+        if let Err(e) = stream.write_all(&buf) {
+            debug!("Control socket write failed: {}", e);
+        }
+    }
+}
+
+/// Parse a 9-byte binary request
+fn parse_request(buf: &[u8; REQUEST_LEN]) -> Option<SocketRequest> {
+    let arg = u64::from_le_bytes(buf[1..9].try_into().unwrap());
+    match buf[0] {
+        OP_SET_BURST_THRESHOLD => Some(SocketRequest::Command(ControlCommand::SetBurstThreshold(
+            arg,
+        ))),
+        OP_SET_SLICE => Some(SocketRequest::Command(ControlCommand::SetSlice(arg))),
+        OP_SET_GAMING_MODE => Some(SocketRequest::Command(ControlCommand::GamingMode(arg != 0))),
+        OP_SET_WORK_MODE => Some(SocketRequest::Command(ControlCommand::WorkMode(arg != 0))),
+        OP_GET_STATS => Some(SocketRequest::GetStats),
+        OP_GET_HANDOFF => Some(SocketRequest::GetHandoff),
+        _ => None,
+    }
+}
+
+/// Fetch a warm-handoff snapshot from an outgoing daemon, if one is still
+/// serving the control socket.
+///
+/// Called at startup, before this instance binds its own socket and
+/// attaches struct_ops. Every failure mode - no socket, nobody listening,
+/// timeout, version mismatch, malformed payload - simply means a normal
+/// cold start, so this never returns an error.
+pub fn fetch_handoff() -> Option<HandoffState> {
+    let mut stream = UnixStream::connect(SOCKET_PATH).ok()?;
+    stream.set_read_timeout(Some(HANDOFF_FETCH_TIMEOUT)).ok()?;
+    stream.set_write_timeout(Some(HANDOFF_FETCH_TIMEOUT)).ok()?;
+
+    let mut request = [0u8; REQUEST_LEN];
+    request[0] = OP_GET_HANDOFF;
+    stream.write_all(&request).ok()?;
+
+    let mut header = [0u8; 5];
+    stream.read_exact(&mut header).ok()?;
+    if header[0] != RESP_OK {
+        debug!("Handoff request refused by outgoing daemon");
+        return None;
+    }
+    let len = u32::from_le_bytes(header[1..5].try_into().unwrap()) as usize;
+    if len == 0 || len > MAX_HANDOFF_PAYLOAD {
+        debug!("Handoff payload length {} out of range", len);
+        return None;
+    }
+    let mut payload = vec![0u8; len];
+    stream.read_exact(&mut payload).ok()?;
+
+    match serde_json::from_slice::<HandoffState>(&payload) {
+        Ok(state) if state.version == HANDOFF_VERSION => Some(state),
+        Ok(state) => {
+            warn!(
+                "Handoff version mismatch ({} != {}) - cold start",
+                state.version, HANDOFF_VERSION
+            );
+            None
+        }
+        Err(e) => {
+            warn!("Malformed handoff payload: {} - cold start", e);
+            None
+        }
+    }
+}
+
 /// Control interface manager
 pub struct ControlInterface {
     control_dir: PathBuf,
     control_file: PathBuf,
+    socket_path: PathBuf,
+    listener: Option<UnixListener>,
     last_modified: Option<std::time::SystemTime>,
 }
 
@@ -37,10 +218,13 @@ impl ControlInterface {
     pub fn new() -> Self {
         let control_dir = PathBuf::from("/run/ghostbrew");
         let control_file = control_dir.join("control");
+        let socket_path = PathBuf::from(SOCKET_PATH);
 
         Self {
             control_dir,
             control_file,
+            socket_path,
+            listener: None,
             last_modified: None,
         }
     }
@@ -81,10 +265,90 @@ impl ControlInterface {
             fs::set_permissions(&self.control_file, file_perms).ok();
         }
 
+        // Bring up the binary control socket. A stale socket from a crashed
+        // daemon must be removed before bind succeeds.
+        let _ = fs::remove_file(&self.socket_path);
+        match UnixListener::bind(&self.socket_path) {
+            Ok(listener) => {
+                listener
+                    .set_nonblocking(true)
+                    .context("Failed to set control socket non-blocking")?;
+
+                #[cfg(unix)]
+                {
+                    use std::os::unix::fs::PermissionsExt;
+                    let sock_perms = fs::Permissions::from_mode(0o600);
+                    fs::set_permissions(&self.socket_path, sock_perms).ok();
+                }
+
+                info!("Control socket: {:?}", self.socket_path);
+                self.listener = Some(listener);
+            }
+            Err(e) => {
+                warn!(
+                    "Failed to bind control socket {:?}: {} - file interface only",
+                    self.socket_path, e
+                );
+            }
+        }
+
         info!("Control interface: {:?}", self.control_file);
         Ok(())
     }
 
+    /// Accept pending socket clients and parse their requests.
+    ///
+    /// Called from the 100ms main-loop tick, so tunable pushes apply on the
+    /// next tick rather than waiting for the stats interval like the control
+    /// file. Clients with malformed requests get an error response and are
+    /// dropped here; valid requests are returned for the scheduler to answer.
+    pub fn poll_socket(&mut self) -> Vec<SocketClient> {
+        let mut clients = Vec::new();
+        let Some(listener) = self.listener.as_ref() else {
+            return clients;
+        };
+
+        for _ in 0..MAX_ACCEPTS_PER_POLL {
+            let stream = match listener.accept() {
+                Ok((stream, _)) => stream,
+                Err(e) if e.kind() == std::io::ErrorKind::WouldBlock => break,
+                Err(e) => {
+                    debug!("Control socket accept failed: {}", e);
+                    break;
+                }
+            };
+
+            // The accepted stream inherits non-blocking from the listener;
+            // switch to short blocking reads so a slow client can't wedge
+            // the loop but a normal one always gets its request through.
+            if stream.set_nonblocking(false).is_err() {
+                continue;
+            }
+            let _ = stream.set_read_timeout(Some(CLIENT_IO_TIMEOUT));
+            let _ = stream.set_write_timeout(Some(CLIENT_IO_TIMEOUT));
+
+            let mut stream = stream;
+            let mut buf = [0u8; REQUEST_LEN];
+            if let Err(e) = stream.read_exact(&mut buf) {
+                debug!("Control socket short read: {}", e);
+                continue;
+            }
+
+            match parse_request(&buf) {
+                Some(request) => {
+                    debug!("Control socket request: {:?}", request);
+                    clients.push(SocketClient { stream, request });
+                }
+                None => {
+                    warn!("Unknown control socket opcode: {}", buf[0]);
+                    SocketClient::write_response(&mut stream, RESP_ERR, &[]);
+                }
+            }
+        }
+
+        clients
+    }
+
     /// Check for and parse control commands
     pub fn poll_commands(&mut self) -> Vec<ControlCommand> {
         let mut commands = Vec::new();
@@ -195,4 +459,53 @@ mod tests {
         assert!(ControlInterface::parse_command("# comment").is_none());
         assert!(ControlInterface::parse_command("invalid").is_none());
     }
+
+    #[test]
+    fn test_parse_socket_request() {
+        let mut buf = [0u8; 9];
+        buf[0] = OP_SET_SLICE;
+        buf[1..9].copy_from_slice(&2_000_000u64.to_le_bytes());
+        assert!(matches!(
+            parse_request(&buf),
+            Some(SocketRequest::Command(ControlCommand::SetSlice(2_000_000)))
+        ));
+
+        buf[0] = OP_SET_GAMING_MODE;
+        buf[1..9].copy_from_slice(&1u64.to_le_bytes());
+        assert!(matches!(
+            parse_request(&buf),
+            Some(SocketRequest::Command(ControlCommand::GamingMode(true)))
+        ));
+
+        buf[0] = OP_GET_STATS;
+        assert!(matches!(parse_request(&buf), Some(SocketRequest::GetStats)));
+
+        buf[0] = OP_GET_HANDOFF;
+        assert!(matches!(
+            parse_request(&buf),
+            Some(SocketRequest::GetHandoff)
+        ));
+
+        buf[0] = 99;
+        assert!(parse_request(&buf).is_none());
+    }
+
+    #[test]
+    fn test_handoff_state_roundtrip() {
+        let state = HandoffState {
+            version: HANDOFF_VERSION,
+            gaming_pids: vec![(1234, 1), (5678, 3)],
+            vm_pids: vec![(4321, 6)],
+            container_pids: vec![(8765, 7)],
+            active_profiles: vec![(1234, "Cyberpunk 2077".to_string())],
+            tunables: vec![0u8; 24],
+        };
+
+        let payload = serde_json::to_vec(&state).unwrap();
+        let decoded: HandoffState = serde_json::from_slice(&payload).unwrap();
+        assert_eq!(decoded.version, HANDOFF_VERSION);
+        assert_eq!(decoded.gaming_pids, state.gaming_pids);
+        assert_eq!(decoded.active_profiles[0].1, "Cyberpunk 2077");
+        assert_eq!(decoded.tunables.len(), 24);
+    }
 }
@@ -10,9 +10,13 @@
 use libbpf_rs::{RingBuffer, RingBufferBuilder};
 use log::{debug, info, warn};
 use std::sync::Arc;
-use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::time::Duration;
 
+/// Poll timeout for the dedicated consumer thread; doubles as its
+/// shutdown-check granularity
+const EVENT_POLL_TIMEOUT: Duration = Duration::from_millis(100);
+
 /// Event types matching BPF side
 pub const EVENT_GAMING_DETECTED: u32 = 1;
 pub const EVENT_VCACHE_MIGRATION: u32 = 2;
@@ -20,6 +24,10 @@ pub const EVENT_PREEMPT_KICK: u32 = 3;
 pub const EVENT_HIGH_LATENCY: u32 = 4;
 pub const EVENT_CCD_IMBALANCE: u32 = 5;
 pub const EVENT_PROFILE_MATCH: u32 = 6;
+pub const EVENT_PROC_EXEC: u32 = 7;
+/// Coalesced record from in-BPF aggregation: value1 = original event type,
+/// value2 = occurrence count, timestamp = start of the coalescing window
+pub const EVENT_AGGREGATE: u32 = 8;
 
 /// Event structure matching BPF sched_event
 #[repr(C)]
@@ -52,6 +60,8 @@ impl SchedEvent {
             EVENT_HIGH_LATENCY => "HighLatency",
             EVENT_CCD_IMBALANCE => "CCDImbalance",
             EVENT_PROFILE_MATCH => "ProfileMatch",
+            EVENT_PROC_EXEC => "ProcExec",
+            EVENT_AGGREGATE => "Aggregate",
             _ => "Unknown",
         }
     }
@@ -108,6 +118,23 @@ impl SchedEvent {
                     self.cpu
                 )
             }
+            EVENT_PROC_EXEC => {
+                format!("Process exec: {} (PID {})", self.comm_str(), self.pid)
+            }
+            EVENT_AGGREGATE => {
+                let original = match self.value1 as u32 {
+                    EVENT_PREEMPT_KICK => "preempt kicks",
+                    EVENT_HIGH_LATENCY => "high-latency events",
+                    _ => "events",
+                };
+                format!(
+                    "Aggregated: {} {} for {} (PID {})",
+                    self.value2,
+                    original,
+                    self.comm_str(),
+                    self.pid
+                )
+            }
             _ => format!("Unknown event type {}", self.event_type),
         }
     }
@@ -122,6 +149,7 @@ pub struct EventCounters {
     pub high_latency: AtomicU64,
     pub ccd_imbalance: AtomicU64,
     pub profile_matches: AtomicU64,
+    pub proc_execs: AtomicU64,
     #[allow(dead_code)]
     pub dropped: AtomicU64,
 }
@@ -139,6 +167,16 @@ impl EventCounters {
             EVENT_HIGH_LATENCY => self.high_latency.fetch_add(1, Ordering::Relaxed),
             EVENT_CCD_IMBALANCE => self.ccd_imbalance.fetch_add(1, Ordering::Relaxed),
             EVENT_PROFILE_MATCH => self.profile_matches.fetch_add(1, Ordering::Relaxed),
+            EVENT_PROC_EXEC => self.proc_execs.fetch_add(1, Ordering::Relaxed),
+            // Credit coalesced occurrences to the original counter so the
+            // summary stays accurate across mode switches
+            EVENT_AGGREGATE => match event.value1 as u32 {
+                EVENT_PREEMPT_KICK => self
+                    .preempt_kicks
+                    .fetch_add(event.value2, Ordering::Relaxed),
+                EVENT_HIGH_LATENCY => self.high_latency.fetch_add(event.value2, Ordering::Relaxed),
+                _ => 0,
+            },
             _ => 0,
         };
     }
@@ -158,13 +196,21 @@ impl EventCounters {
 /// Event handler that processes incoming events
 pub struct EventHandler {
     pub counters: Arc<EventCounters>,
+    /// PIDs reported by the BPF sched_process_exec tracepoint, drained by
+    /// the main loop for incremental gaming classification
+    pub exec_pids: crossbeam::queue::SegQueue<u32>,
+    /// Flight recorder sink; when set, events are appended raw and the
+    /// per-event log formatting below is skipped entirely
+    recorder: Option<Arc<crate::recorder::FlightRecorder>>,
     pub verbose: bool,
 }
 
 impl EventHandler {
-    pub fn new(verbose: bool) -> Self {
+    pub fn new(verbose: bool, recorder: Option<Arc<crate::recorder::FlightRecorder>>) -> Self {
         Self {
             counters: Arc::new(EventCounters::new()),
+            exec_pids: crossbeam::queue::SegQueue::new(),
+            recorder,
             verbose,
         }
     }
@@ -182,6 +228,24 @@ impl EventHandler {
         // Record in counters
         self.counters.record(event);
 
+        // Flight-recorder mode: raw append with zero formatting/allocation
+        // on the hot path. Exec PIDs still feed the gaming detector.
+        if let Some(recorder) = &self.recorder {
+            recorder.record(data);
+            if event.event_type == EVENT_PROC_EXEC {
+                self.exec_pids.push(event.pid);
+            }
+            return 0;
+        }
+
+        // Queue exec notifications for the gaming detector (high rate, so
+        // skip the formatting below except when debugging)
+        if event.event_type == EVENT_PROC_EXEC {
+            self.exec_pids.push(event.pid);
+            debug!("[EVENT] {}", event.format());
+            return 0;
+        }
+
         // Log if verbose
         if self.verbose {
             info!("[EVENT] {}", event.format());
@@ -194,8 +258,8 @@ impl EventHandler {
 }
 
 /// Build a ringbuf consumer for the events map
-pub fn build_ringbuf<'a>(
-    events_map: &'a libbpf_rs::Map,
+pub fn build_ringbuf<'a, M: libbpf_rs::MapCore>(
+    events_map: &'a M,
     handler: Arc<EventHandler>,
 ) -> Result<RingBuffer<'a>, libbpf_rs::Error> {
     let handler_clone = handler.clone();
@@ -213,6 +277,39 @@ pub fn poll_events(ringbuf: &RingBuffer, timeout: Duration) -> Result<(), libbpf
     ringbuf.poll(timeout)
 }
 
+/// Spawn the dedicated ringbuf consumer thread.
+///
+/// The consumer must never share a thread with the procfs/cgroup
+/// scanners: when it did, a slow container rescan stalled polling for
+/// its whole duration and dropped events under churn. The map handle is
+/// a dup'd fd, so the thread owns its consumer independent of the
+/// skeleton borrow; the ringbuf itself is built inside the thread
+/// because it borrows the handle. Exec PIDs cross back to the control
+/// plane over the handler's lock-free queue.
+pub fn spawn_event_thread(
+    events_map: libbpf_rs::MapHandle,
+    handler: Arc<EventHandler>,
+    shutdown: Arc<AtomicBool>,
+) -> std::io::Result<std::thread::JoinHandle<()>> {
+    std::thread::Builder::new()
+        .name("ghostbrew-events".to_string())
+        .spawn(move || {
+            let ringbuf = match build_ringbuf(&events_map, handler) {
+                Ok(rb) => rb,
+                Err(e) => {
+                    warn!("Failed to build ringbuf consumer: {} - events disabled", e);
+                    return;
+                }
+            };
+
+            while !shutdown.load(Ordering::Relaxed) {
+                if let Err(e) = ringbuf.poll(EVENT_POLL_TIMEOUT) {
+                    debug!("Ringbuf poll error: {}", e);
+                }
+            }
+        })
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
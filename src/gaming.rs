@@ -99,35 +99,28 @@ fn classify_process(pid: u32) -> Option<u32> {
     None
 }
 
-/// Check /proc/[pid]/exe for gaming patterns
-fn check_exe_path(pid: u32) -> Option<u32> {
-    let exe_path = format!("/proc/{}/exe", pid);
-
-    let exe = match fs::read_link(&exe_path) {
-        Ok(p) => p,
-        Err(_) => return None,
-    };
-
-    let exe_str = exe.to_string_lossy().to_lowercase();
+/// Classify an executable path or name by pattern
+///
+/// Pure string matching so the replay bench can drive it with recorded
+/// comms; `check_exe_path` wraps it with the /proc readlink.
+pub fn classify_exe_name(exe_name: &str) -> Option<u32> {
+    let exe_str = exe_name.to_lowercase();
 
     // Check for gaming patterns
     for pattern in GAMING_EXE_PATTERNS {
         if exe_str.contains(pattern) {
-            debug!("PID {} detected as gaming via exe: {}", pid, exe_str);
             return Some(WORKLOAD_GAMING);
         }
     }
 
     // Check for .exe suffix (Wine/Proton)
     if exe_str.ends_with(".exe") {
-        debug!("PID {} detected as gaming via .exe: {}", pid, exe_str);
         return Some(WORKLOAD_GAMING);
     }
 
     // Check for dev/build patterns before broad AI handling.
     for pattern in DEV_EXE_PATTERNS {
         if exe_str.contains(pattern) {
-            debug!("PID {} detected as dev/batch via exe: {}", pid, exe_str);
             return Some(WORKLOAD_BATCH);
         }
     }
@@ -139,7 +132,6 @@ fn check_exe_path(pid: u32) -> Option<u32> {
             if *pattern == "python" {
                 return None; // Let environ check handle python
             }
-            debug!("PID {} detected as AI via exe: {}", pid, exe_str);
             return Some(WORKLOAD_AI);
         }
     }
@@ -147,6 +139,20 @@ fn check_exe_path(pid: u32) -> Option<u32> {
     None
 }
 
+/// Check /proc/[pid]/exe for gaming patterns
+fn check_exe_path(pid: u32) -> Option<u32> {
+    let exe_path = format!("/proc/{}/exe", pid);
+
+    let exe = match fs::read_link(&exe_path) {
+        Ok(p) => p,
+        Err(_) => return None,
+    };
+
+    let class = classify_exe_name(&exe.to_string_lossy())?;
+    debug!("PID {} classified as {} via exe: {:?}", pid, class, exe);
+    Some(class)
+}
+
 /// Check /proc/[pid]/environ for gaming environment variables
 fn check_environ(pid: u32) -> Option<u32> {
     let environ_path = format!("/proc/{}/environ", pid);
@@ -274,6 +280,113 @@ impl GamingDetector {
         Ok((new_pids, removed_pids))
     }
 
+    /// Classify freshly exec'd PIDs reported by the BPF exec tracepoint.
+    ///
+    /// Only touches /proc for the given PIDs, unlike the full scan in
+    /// `scan_changes` (which is kept as a startup-only seed pass).
+    /// Returns newly classified (pid, class) pairs.
+    pub fn classify_exec_pids(&mut self, pids: &[u32]) -> Vec<(u32, u32)> {
+        let mut new_pids = Vec::new();
+
+        for &pid in pids {
+            if let Some(class) = classify_process(pid) {
+                let inserted = match class {
+                    WORKLOAD_GAMING => self.known_gaming_pids.insert(pid),
+                    WORKLOAD_BATCH => self.known_batch_pids.insert(pid),
+                    WORKLOAD_AI => self.known_ai_pids.insert(pid),
+                    _ => false,
+                };
+                if inserted {
+                    new_pids.push((pid, class));
+                }
+            }
+        }
+
+        if !new_pids.is_empty() {
+            info!("Gaming detector: {} new from exec events", new_pids.len());
+        }
+
+        new_pids
+    }
+
+    /// Drop tracked PIDs whose processes have exited.
+    ///
+    /// One /proc existence check per *tracked* PID - much cheaper than the
+    /// full rescan when exec events handle additions.
+    pub fn prune_dead_pids(&mut self) -> Vec<u32> {
+        let mut removed = Vec::new();
+
+        for set in [
+            &mut self.known_gaming_pids,
+            &mut self.known_batch_pids,
+            &mut self.known_ai_pids,
+        ] {
+            set.retain(|&pid| {
+                let alive = std::path::Path::new(&format!("/proc/{}", pid)).exists();
+                if !alive {
+                    removed.push(pid);
+                }
+                alive
+            });
+        }
+
+        if !removed.is_empty() {
+            debug!("Gaming detector: pruned {} dead PIDs", removed.len());
+        }
+
+        removed
+    }
+
+    /// Snapshot all tracked (pid, class) pairs for warm handoff
+    pub fn snapshot(&self) -> Vec<(u32, u32)> {
+        let mut pairs = Vec::with_capacity(
+            self.known_gaming_pids.len() + self.known_batch_pids.len() + self.known_ai_pids.len(),
+        );
+        for &pid in &self.known_gaming_pids {
+            pairs.push((pid, WORKLOAD_GAMING));
+        }
+        for &pid in &self.known_batch_pids {
+            pairs.push((pid, WORKLOAD_BATCH));
+        }
+        for &pid in &self.known_ai_pids {
+            pairs.push((pid, WORKLOAD_AI));
+        }
+        pairs
+    }
+
+    /// Seed the detector from a predecessor's handoff snapshot.
+    ///
+    /// PIDs that exited during the handoff window are skipped. Returns the
+    /// pairs actually accepted, so the caller can pre-populate the BPF map
+    /// with exactly the same set.
+    pub fn restore(&mut self, pairs: &[(u32, u32)]) -> Vec<(u32, u32)> {
+        let mut accepted = Vec::new();
+
+        for &(pid, class) in pairs {
+            if !std::path::Path::new(&format!("/proc/{}", pid)).exists() {
+                continue;
+            }
+            let inserted = match class {
+                WORKLOAD_GAMING => self.known_gaming_pids.insert(pid),
+                WORKLOAD_BATCH => self.known_batch_pids.insert(pid),
+                WORKLOAD_AI => self.known_ai_pids.insert(pid),
+                _ => false,
+            };
+            if inserted {
+                accepted.push((pid, class));
+            }
+        }
+
+        if !accepted.is_empty() {
+            info!(
+                "Gaming detector: restored {} PIDs from handoff",
+                accepted.len()
+            );
+        }
+
+        accepted
+    }
+
     /// Get counts for logging
     pub fn counts(&self) -> (usize, usize, usize) {
         (
@@ -322,6 +435,23 @@ mod tests {
         assert!(result.is_ok());
     }
 
+    #[test]
+    fn test_classify_exe_name() {
+        assert_eq!(
+            classify_exe_name("Cyberpunk2077.exe"),
+            Some(WORKLOAD_GAMING)
+        );
+        assert_eq!(
+            classify_exe_name("/usr/bin/gamescope"),
+            Some(WORKLOAD_GAMING)
+        );
+        assert_eq!(classify_exe_name("/usr/bin/rustc"), Some(WORKLOAD_BATCH));
+        assert_eq!(classify_exe_name("/usr/bin/ollama"), Some(WORKLOAD_AI));
+        // python defers to the environ check
+        assert_eq!(classify_exe_name("/usr/bin/python3"), None);
+        assert_eq!(classify_exe_name("/usr/bin/bash"), None);
+    }
+
     #[test]
     fn test_dev_build_patterns_are_classified_as_batch() {
         for exe in [
@@ -336,4 +466,20 @@ mod tests {
             assert!(DEV_EXE_PATTERNS.iter().any(|pattern| exe.contains(pattern)));
         }
     }
+
+    #[test]
+    fn test_snapshot_restore_skips_dead_pids() {
+        let live_pid = std::process::id();
+        let dead_pid = u32::MAX - 1; // Far above any real PID
+
+        let mut detector = GamingDetector::new();
+        let accepted = detector.restore(&[(live_pid, WORKLOAD_GAMING), (dead_pid, WORKLOAD_BATCH)]);
+
+        assert_eq!(accepted, vec![(live_pid, WORKLOAD_GAMING)]);
+        assert_eq!(detector.counts(), (1, 0, 0));
+        assert_eq!(detector.snapshot(), vec![(live_pid, WORKLOAD_GAMING)]);
+
+        // Restoring the same PID again is a no-op
+        assert!(detector.restore(&[(live_pid, WORKLOAD_GAMING)]).is_empty());
+    }
 }
@@ -8,6 +8,10 @@ use anyhow::{Context, Result};
 use log::{debug, info};
 use std::fs;
 use std::path::Path;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, AtomicU8, AtomicU32, Ordering};
+use std::thread;
+use std::time::Duration;
 
 /// GPU power state
 #[derive(Debug, Clone, Copy, PartialEq)]
@@ -326,21 +330,8 @@ impl GpuMonitor {
     /// Tries multiple sources in order:
     /// 1. AMD sysfs (gpu_busy_percent)
     /// 2. NVIDIA nvidia-smi (fallback)
-    #[allow(dead_code)] // Scaffolding for future GPU coordination
     pub fn read_gpu_utilization(&self) -> Option<u32> {
-        // Try AMD sysfs first (works for AMD GPUs)
-        if let Ok(util) = Self::read_amd_gpu_util() {
-            return Some(util);
-        }
-
-        // Try NVIDIA sysfs (hwmon)
-        if let Some(gpu) = self.primary_gpu()
-            && let Ok(util) = Self::read_nvidia_gpu_util(&gpu.pci_address)
-        {
-            return Some(util);
-        }
-
-        None
+        read_gpu_utilization_at(self.primary_gpu().map(|g| g.pci_address.as_str()))
     }
 
     /// Read AMD GPU utilization from sysfs
@@ -391,27 +382,34 @@ impl GpuMonitor {
     }
 
     /// Detect GPU bottleneck state based on utilization
-    ///
-    /// Returns:
-    /// - GpuBound if utilization >95%
-    /// - CpuBound if utilization <50%
-    /// - Balanced otherwise
-    #[allow(dead_code)] // Scaffolding for future GPU coordination
+    #[allow(dead_code)] // Synchronous variant; GpuSampler is the live path
     pub fn detect_bottleneck(&self) -> GpuBottleneck {
-        let Some(util) = self.read_gpu_utilization() else {
-            return GpuBottleneck::Balanced;
-        };
-
-        if util > 95 {
-            GpuBottleneck::GpuBound
-        } else if util < 50 {
-            GpuBottleneck::CpuBound
-        } else {
-            GpuBottleneck::Balanced
+        match self.read_gpu_utilization() {
+            Some(util) => GpuBottleneck::from_utilization(util),
+            None => GpuBottleneck::Balanced,
         }
     }
 }
 
+/// Read GPU utilization for a primary GPU at the given PCI address
+///
+/// Free function so the sampler thread can poll without owning a GpuMonitor.
+fn read_gpu_utilization_at(pci_address: Option<&str>) -> Option<u32> {
+    // Try AMD sysfs first (works for AMD GPUs)
+    if let Ok(util) = GpuMonitor::read_amd_gpu_util() {
+        return Some(util);
+    }
+
+    // Try NVIDIA (nvidia-smi, then /proc)
+    if let Some(pci) = pci_address
+        && let Ok(util) = GpuMonitor::read_nvidia_gpu_util(pci)
+    {
+        return Some(util);
+    }
+
+    None
+}
+
 impl Default for GpuMonitor {
     fn default() -> Self {
         Self::new().unwrap_or(Self {
@@ -438,7 +436,6 @@ pub const GPU_THREAD_PATTERNS: &[&str] = &[
 ];
 
 /// GPU bottleneck state for scheduler coordination
-#[allow(dead_code)] // Scaffolding for future GPU coordination integration
 #[derive(Debug, Clone, Copy, PartialEq, Default)]
 pub enum GpuBottleneck {
     /// GPU utilization >95%: reduce CPU work, let GPU catch up
@@ -450,8 +447,18 @@ pub enum GpuBottleneck {
     Balanced,
 }
 
-#[allow(dead_code)] // Scaffolding for future GPU coordination
 impl GpuBottleneck {
+    /// Classify a utilization percentage
+    pub fn from_utilization(util: u32) -> Self {
+        if util > 95 {
+            GpuBottleneck::GpuBound
+        } else if util < 50 {
+            GpuBottleneck::CpuBound
+        } else {
+            GpuBottleneck::Balanced
+        }
+    }
+
     /// Convert to BPF gpu_bound_mode value
     pub fn as_bpf_mode(self) -> u8 {
         match self {
@@ -460,6 +467,99 @@ impl GpuBottleneck {
             GpuBottleneck::CpuBound => 2,
         }
     }
+
+    /// Convert from BPF gpu_bound_mode value
+    pub fn from_bpf_mode(mode: u8) -> Self {
+        match mode {
+            1 => GpuBottleneck::GpuBound,
+            2 => GpuBottleneck::CpuBound,
+            _ => GpuBottleneck::Balanced,
+        }
+    }
+}
+
+/// Sampling interval for the background GPU utilization thread
+const GPU_SAMPLE_INTERVAL_MS: u64 = 500;
+
+/// Utilization snapshot value meaning "no reading available"
+const GPU_UTIL_UNKNOWN: u32 = u32::MAX;
+
+/// Background GPU utilization sampler
+///
+/// Reading utilization can shell out to nvidia-smi and touch sysfs/procfs,
+/// which is far too slow for the 100ms main loop. A dedicated thread samples
+/// on its own cadence and publishes the latest reading and bottleneck verdict
+/// through atomics, so the main loop reads a cached snapshot without blocking
+/// or locking.
+pub struct GpuSampler {
+    bottleneck: Arc<AtomicU8>,
+    utilization: Arc<AtomicU32>,
+    stop: Arc<AtomicBool>,
+    handle: Option<thread::JoinHandle<()>>,
+}
+
+impl GpuSampler {
+    /// Spawn the sampling thread for the primary GPU
+    pub fn spawn(pci_address: Option<String>) -> Result<Self> {
+        let bottleneck = Arc::new(AtomicU8::new(GpuBottleneck::default().as_bpf_mode()));
+        let utilization = Arc::new(AtomicU32::new(GPU_UTIL_UNKNOWN));
+        let stop = Arc::new(AtomicBool::new(false));
+
+        let thread_bottleneck = bottleneck.clone();
+        let thread_utilization = utilization.clone();
+        let thread_stop = stop.clone();
+        let handle = thread::Builder::new()
+            .name("ghostbrew-gpu".to_string())
+            .spawn(move || {
+                while !thread_stop.load(Ordering::Relaxed) {
+                    match read_gpu_utilization_at(pci_address.as_deref()) {
+                        Some(util) => {
+                            thread_utilization.store(util, Ordering::Relaxed);
+                            thread_bottleneck.store(
+                                GpuBottleneck::from_utilization(util).as_bpf_mode(),
+                                Ordering::Relaxed,
+                            );
+                        }
+                        None => {
+                            thread_utilization.store(GPU_UTIL_UNKNOWN, Ordering::Relaxed);
+                            thread_bottleneck
+                                .store(GpuBottleneck::Balanced.as_bpf_mode(), Ordering::Relaxed);
+                        }
+                    }
+                    thread::sleep(Duration::from_millis(GPU_SAMPLE_INTERVAL_MS));
+                }
+            })
+            .context("Failed to spawn GPU sampler thread")?;
+
+        Ok(Self {
+            bottleneck,
+            utilization,
+            stop,
+            handle: Some(handle),
+        })
+    }
+
+    /// Latest bottleneck verdict (lock-free snapshot)
+    pub fn bottleneck(&self) -> GpuBottleneck {
+        GpuBottleneck::from_bpf_mode(self.bottleneck.load(Ordering::Relaxed))
+    }
+
+    /// Latest utilization reading, if any source is available
+    pub fn utilization(&self) -> Option<u32> {
+        match self.utilization.load(Ordering::Relaxed) {
+            GPU_UTIL_UNKNOWN => None,
+            util => Some(util),
+        }
+    }
+}
+
+impl Drop for GpuSampler {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
 }
 
 impl std::fmt::Display for GpuBottleneck {
@@ -491,6 +591,22 @@ mod tests {
         let _result = detect_nvidia_gpus();
     }
 
+    #[test]
+    fn test_bottleneck_from_utilization() {
+        assert_eq!(GpuBottleneck::from_utilization(99), GpuBottleneck::GpuBound);
+        assert_eq!(GpuBottleneck::from_utilization(70), GpuBottleneck::Balanced);
+        assert_eq!(GpuBottleneck::from_utilization(20), GpuBottleneck::CpuBound);
+
+        // BPF mode round-trip
+        for b in [
+            GpuBottleneck::GpuBound,
+            GpuBottleneck::CpuBound,
+            GpuBottleneck::Balanced,
+        ] {
+            assert_eq!(GpuBottleneck::from_bpf_mode(b.as_bpf_mode()), b);
+        }
+    }
+
     #[test]
     fn test_is_gpu_thread_name() {
         assert!(is_gpu_thread_name("VkThread-0"));
@@ -175,6 +175,69 @@ fn detect_by_frequency(
     Ok(())
 }
 
+/// Per-CPU hardware feedback capabilities, normalized to 0-1023
+///
+/// Sourced from Thread Director / HFI via the HWP capability registers. The
+/// kernel does not export the raw HFI table, but on hybrid parts it mirrors
+/// the HFI performance column into the per-CPU CPPC capabilities, which
+/// acpi_cppc sysfs reads live from the registers - so periodic re-reads pick
+/// up hardware feedback changes (thermal derating, favored-core shifts).
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct HfiCap {
+    /// Performance capability (higher = faster core right now)
+    pub perf_cap: u32,
+    /// Sustained (nominal) capability
+    pub eff_cap: u32,
+}
+
+/// Scale hardware feedback caps to the 0-1023 range used by the BPF side
+fn normalize_hfi_caps(raw: &[(u32, u32)]) -> Vec<HfiCap> {
+    let max_perf = raw.iter().map(|(p, _)| *p).max().unwrap_or(0);
+    if max_perf == 0 {
+        return vec![HfiCap::default(); raw.len()];
+    }
+
+    raw.iter()
+        .map(|&(perf, eff)| HfiCap {
+            perf_cap: perf * 1023 / max_perf,
+            eff_cap: eff * 1023 / max_perf,
+        })
+        .collect()
+}
+
+/// Read per-CPU hardware feedback capabilities for all CPUs
+///
+/// Returns None when the platform doesn't expose CPPC capabilities (no HWP,
+/// or acpi_cppc not mounted), in which case placement falls back to the
+/// static capacity-based rankings.
+pub fn read_hfi_caps(nr_cpus: u32) -> Option<Vec<HfiCap>> {
+    let mut raw = Vec::with_capacity(nr_cpus as usize);
+    let mut any = false;
+
+    for cpu in 0..nr_cpus {
+        let base = format!("/sys/devices/system/cpu/cpu{}/acpi_cppc", cpu);
+        let perf = read_cppc_value(&format!("{}/highest_perf", base)).unwrap_or(0);
+        let eff = read_cppc_value(&format!("{}/nominal_perf", base)).unwrap_or(0);
+
+        if perf > 0 {
+            any = true;
+        }
+        raw.push((perf, eff));
+    }
+
+    if !any {
+        debug!("ACPI CPPC capabilities not available, no HFI feedback");
+        return None;
+    }
+
+    Some(normalize_hfi_caps(&raw))
+}
+
+/// Read a single CPPC capability value
+fn read_cppc_value(path: &str) -> Option<u32> {
+    fs::read_to_string(path).ok()?.trim().parse().ok()
+}
+
 /// Read base frequency from cpufreq
 fn read_base_frequency(cpu: u32) -> Result<u32> {
     // Try base_frequency first (preferred)
@@ -225,6 +288,19 @@ mod tests {
         assert_eq!(is_intel_hybrid_model("AMD Ryzen 7 7800X3D"), None);
     }
 
+    #[test]
+    fn test_normalize_hfi_caps() {
+        // P-core at full cap, E-core at ~60%
+        let caps = normalize_hfi_caps(&[(255, 160), (152, 152)]);
+        assert_eq!(caps[0].perf_cap, 1023);
+        assert!(caps[1].perf_cap < caps[0].perf_cap);
+        assert!(caps[1].perf_cap > 500);
+
+        // No data -> all zeros, not a divide-by-zero
+        let empty = normalize_hfi_caps(&[(0, 0), (0, 0)]);
+        assert_eq!(empty[0], HfiCap::default());
+    }
+
     #[test]
     fn test_pcore_threshold() {
         // P-cores should be >= 900 capacity
@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: GPL-2.0
+//
+// GhostBrew - Per-Task L3 Miss Sampling
+//
+// Measures each tracked task's L3 miss ratio with perf hardware cache
+// counters (LLC references/misses, counting mode - no sampling buffers)
+// and turns it into a 0-100 cache-sensitivity score for the BPF
+// task_cache_scores map. The V-Cache placement in select_cpu then weighs
+// what a task measurably gets from the 96MB L3 instead of assuming class
+// implies working-set size. The amd_l3 uncore PMU is per-CCX and cannot
+// be attached to a PID, so the core PMU's generic LLC events are used.
+//
+// Counters inherit across a task's threads, so one fd pair per tracked
+// TGID covers the whole process.
+//
+// Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
+
+use log::{debug, info};
+use std::collections::HashMap;
+use std::fs::File;
+use std::io::Read;
+use std::os::fd::FromRawFd;
+
+/// perf_event_attr type/config for the generic LLC events
+const PERF_TYPE_HARDWARE: u32 = 0;
+const PERF_COUNT_HW_CACHE_REFERENCES: u64 = 2;
+const PERF_COUNT_HW_CACHE_MISSES: u64 = 3;
+
+/// perf_event_attr flag bits (first bitfield word)
+const ATTR_FLAG_INHERIT: u64 = 1 << 1;
+const ATTR_FLAG_EXCLUDE_KERNEL: u64 = 1 << 5;
+const ATTR_FLAG_EXCLUDE_HV: u64 = 1 << 6;
+
+/// Below this many LLC references per interval the miss ratio is noise
+const MIN_SAMPLE_ACCESSES: u64 = 10_000;
+
+/// Scores are the miss ratio in percent
+pub const CACHE_SCORE_MAX: u32 = 100;
+
+/// Minimal perf_event_attr layout for counting-mode events.
+///
+/// Only the leading fields are populated; the kernel accepts any
+/// recognized size with zeroed tail. Defined here rather than pulled from
+/// libc so the flag-word bit positions are explicit.
+#[repr(C)]
+#[derive(Clone, Copy, Default)]
+struct PerfEventAttr {
+    type_: u32,
+    size: u32,
+    config: u64,
+    sample_period_or_freq: u64,
+    sample_type: u64,
+    read_format: u64,
+    flags: u64,
+    wakeup: u32,
+    bp_type: u32,
+    config1: u64,
+    config2: u64,
+    branch_sample_type: u64,
+    sample_regs_user: u64,
+    sample_stack_user: u32,
+    clockid: i32,
+    sample_regs_intr: u64,
+    aux_watermark: u32,
+    sample_max_stack: u16,
+    reserved_2: u16,
+    aux_sample_size: u32,
+    reserved_3: u32,
+}
+
+/// Open a counting-mode perf event on a PID (all CPUs)
+fn open_counter(pid: u32, config: u64) -> Option<File> {
+    let mut attr = PerfEventAttr {
+        type_: PERF_TYPE_HARDWARE,
+        size: std::mem::size_of::<PerfEventAttr>() as u32,
+        config,
+        flags: ATTR_FLAG_INHERIT | ATTR_FLAG_EXCLUDE_KERNEL | ATTR_FLAG_EXCLUDE_HV,
+        ..Default::default()
+    };
+
+    let fd = unsafe {
+        libc::syscall(
+            libc::SYS_perf_event_open,
+            &mut attr as *mut PerfEventAttr,
+            pid as libc::pid_t,
+            -1i32, // all CPUs
+            -1i32, // no group
+            libc::PERF_FLAG_FD_CLOEXEC as libc::c_ulong,
+        )
+    };
+
+    if fd < 0 {
+        return None;
+    }
+    Some(unsafe { File::from_raw_fd(fd as i32) })
+}
+
+/// Read a counting-mode perf fd (returns the running total)
+fn read_counter(file: &mut File) -> Option<u64> {
+    let mut buf = [0u8; 8];
+    file.read_exact(&mut buf).ok()?;
+    Some(u64::from_ne_bytes(buf))
+}
+
+/// Cache-sensitivity score from one interval's counter deltas.
+///
+/// The score is the L3 miss ratio in percent; intervals with too few
+/// references carry no signal and return None so a stale (but valid)
+/// score is kept.
+fn score_from_deltas(accesses: u64, misses: u64) -> Option<u32> {
+    if accesses < MIN_SAMPLE_ACCESSES {
+        return None;
+    }
+    Some(((misses * CACHE_SCORE_MAX as u64) / accesses).min(CACHE_SCORE_MAX as u64) as u32)
+}
+
+/// Per-task counter pair with the totals at the last sample
+struct TaskCounters {
+    accesses: File,
+    misses: File,
+    last_accesses: u64,
+    last_misses: u64,
+}
+
+/// Samples L3 miss ratios for the classified PID set
+pub struct L3MissSampler {
+    /// perf LLC events usable (permissions and PMU support probed once)
+    available: bool,
+    tasks: HashMap<u32, TaskCounters>,
+    /// Last computed score per PID (kept across low-traffic intervals)
+    scores: HashMap<u32, u32>,
+}
+
+impl L3MissSampler {
+    pub fn new() -> Self {
+        // Probe on our own PID: unprivileged kernels (perf_event_paranoid)
+        // or PMU-less VMs fail here once instead of per tracked task.
+        let available = open_counter(std::process::id(), PERF_COUNT_HW_CACHE_MISSES).is_some();
+        if available {
+            info!("L3 miss sampling available (perf LLC counters)");
+        } else {
+            info!("L3 miss sampling unavailable - V-Cache placement stays class-based");
+        }
+
+        Self {
+            available,
+            tasks: HashMap::new(),
+            scores: HashMap::new(),
+        }
+    }
+
+    pub fn is_available(&self) -> bool {
+        self.available
+    }
+
+    /// Start counting for a PID; a no-op if already tracked.
+    /// Returns false when the counters could not be opened (task exited).
+    pub fn track(&mut self, pid: u32) -> bool {
+        if !self.available || self.tasks.contains_key(&pid) {
+            return self.tasks.contains_key(&pid);
+        }
+
+        let Some(accesses) = open_counter(pid, PERF_COUNT_HW_CACHE_REFERENCES) else {
+            return false;
+        };
+        let Some(misses) = open_counter(pid, PERF_COUNT_HW_CACHE_MISSES) else {
+            return false;
+        };
+
+        debug!("L3 sampler: tracking PID {}", pid);
+        self.tasks.insert(
+            pid,
+            TaskCounters {
+                accesses,
+                misses,
+                last_accesses: 0,
+                last_misses: 0,
+            },
+        );
+        true
+    }
+
+    /// Drop counters for PIDs no longer in the tracked set.
+    /// Returns the removed PIDs so the caller can clean up the BPF map.
+    pub fn retain_tracked(&mut self, tracked: &std::collections::HashSet<u32>) -> Vec<u32> {
+        let removed: Vec<u32> = self
+            .tasks
+            .keys()
+            .filter(|pid| !tracked.contains(pid))
+            .copied()
+            .collect();
+        for pid in &removed {
+            self.tasks.remove(pid);
+            self.scores.remove(pid);
+        }
+        removed
+    }
+
+    /// Read all counters and recompute scores for this interval.
+    /// Returns the (pid, score) pairs that changed since the last sample.
+    pub fn sample(&mut self) -> Vec<(u32, u32)> {
+        let mut changed = Vec::new();
+
+        for (&pid, counters) in self.tasks.iter_mut() {
+            let (Some(accesses), Some(misses)) = (
+                read_counter(&mut counters.accesses),
+                read_counter(&mut counters.misses),
+            ) else {
+                continue;
+            };
+
+            let delta_accesses = accesses.saturating_sub(counters.last_accesses);
+            let delta_misses = misses.saturating_sub(counters.last_misses);
+            counters.last_accesses = accesses;
+            counters.last_misses = misses;
+
+            if let Some(score) = score_from_deltas(delta_accesses, delta_misses)
+                && self.scores.insert(pid, score) != Some(score)
+            {
+                changed.push((pid, score));
+            }
+        }
+
+        changed
+    }
+
+    /// Last known score for a PID (None = unmeasured)
+    pub fn score(&self, pid: u32) -> Option<u32> {
+        self.scores.get(&pid).copied()
+    }
+}
+
+impl Default for L3MissSampler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_score_from_deltas() {
+        // Below the noise floor: no verdict
+        assert_eq!(score_from_deltas(100, 90), None);
+
+        // Miss ratio in percent, capped at 100
+        assert_eq!(score_from_deltas(1_000_000, 250_000), Some(25));
+        assert_eq!(score_from_deltas(1_000_000, 0), Some(0));
+        assert_eq!(score_from_deltas(1_000_000, 2_000_000), Some(100));
+    }
+
+    #[test]
+    fn test_probe_does_not_panic() {
+        // Availability depends on perf_event_paranoid; either way the
+        // sampler must construct cleanly and stay inert when unavailable.
+        let mut sampler = L3MissSampler::new();
+        if !sampler.is_available() {
+            assert!(!sampler.track(std::process::id()));
+            assert!(sampler.sample().is_empty());
+        }
+    }
+}
@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0
+//
+// GhostBrew - library surface for the benchmarks
+//
+// The daemon lives in src/main.rs and declares its modules privately. This
+// lib target exposes only the pure userspace pieces - classification,
+// profile matching, percentile math, flight-recorder decoding and the
+// trace replay harness - so benches/ can drive the real code paths. No BPF
+// skeleton or daemon state is exported here.
+//
+// Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
+
+pub mod events;
+pub mod gaming;
+pub mod mangohud;
+pub mod profiles;
+pub mod recorder;
+pub mod replay;
@@ -5,6 +5,7 @@
 // Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
 
 mod arena;
+mod batch;
 mod bpf_skel;
 mod cgroup;
 mod config;
@@ -14,9 +15,11 @@ mod events;
 mod gaming;
 mod gpu;
 mod intel;
+mod l3miss;
 mod mangohud;
 mod pbo;
 mod profiles;
+mod recorder;
 mod topology;
 mod vcache;
 mod vm;
@@ -70,6 +73,10 @@ struct Args {
     #[arg(long, default_value = "conservative")]
     ecore_offload: String,
 
+    /// Disable SMT isolation (allow batch tasks on gaming threads' SMT siblings)
+    #[arg(long)]
+    no_smt_isolation: bool,
+
     /// Print scheduler statistics periodically
     #[arg(short, long)]
     stats: bool,
@@ -97,6 +104,18 @@ struct Args {
     /// Analyze MangoHud frame time log (show stats without running scheduler)
     #[arg(long)]
     analyze_frametime: Option<Option<std::path::PathBuf>>,
+
+    /// Tail a live MangoHud log, continuously updating FPS lows
+    #[arg(long)]
+    follow_frametime: Option<Option<std::path::PathBuf>>,
+
+    /// Flight recorder - capture raw scheduler events to an mmapped ring file
+    #[arg(long, value_name = "PATH")]
+    record_events: Option<std::path::PathBuf>,
+
+    /// Analyze a recorded event ring file (show stats without running scheduler)
+    #[arg(long)]
+    analyze_events: Option<Option<std::path::PathBuf>>,
 }
 
 /// CPU context structure matching BPF side
@@ -138,6 +157,25 @@ struct Scheduler<'a> {
     control_interface: control::ControlInterface,
     /// Event handler for ringbuf events
     event_handler: Arc<events::EventHandler>,
+    /// Zero-syscall reader over the BPF arena stats plane (kernel 6.18+)
+    arena_reader: Option<arena::ArenaStatsReader>,
+    /// Link for the sched_process_exec tracepoint (None -> periodic scan fallback)
+    exec_link: Option<libbpf_rs::Link>,
+    /// Links for the optional futex hooks (empty -> no futex awareness)
+    #[allow(dead_code)]
+    futex_links: Vec<libbpf_rs::Link>,
+    /// Last published Thread Director/HFI caps (None -> no HFI feedback)
+    hfi_caps: Option<Vec<intel::HfiCap>>,
+    /// Boost-residency sampler re-ranking prefcore live (None -> static)
+    boost_sampler: Option<pbo::BoostSampler>,
+    /// Background GPU utilization sampler (None -> no GPU detected)
+    gpu_sampler: Option<gpu::GpuSampler>,
+    /// Last bottleneck verdict pushed into runtime_tunables
+    gpu_bottleneck: gpu::GpuBottleneck,
+    /// Per-task L3 miss sampler feeding cache-sensitivity scores to BPF
+    l3_sampler: l3miss::L3MissSampler,
+    /// Average measured miss ratio of the batch cohort (feeds V-Cache switching)
+    batch_cache_score: Option<u32>,
 }
 
 impl<'a> Scheduler<'a> {
@@ -312,6 +350,13 @@ impl<'a> Scheduler<'a> {
             );
         }
 
+        // Live re-ranking from boost-residency telemetry (prefcore parts only)
+        let boost_sampler = if prefcore.enabled {
+            Some(pbo::BoostSampler::new(prefcore.rankings.clone()))
+        } else {
+            None
+        };
+
         // Detect NVIDIA GPUs
         let gpu_monitor = gpu::GpuMonitor::default();
         if gpu_monitor.gpu_count() > 0 {
@@ -324,6 +369,25 @@ impl<'a> Scheduler<'a> {
             }
         }
 
+        // Background utilization sampling feeds the bottleneck verdict into
+        // runtime_tunables; utilization reads are too slow for the main loop
+        let gpu_sampler =
+            if gpu_monitor.gpu_count() > 0 || std::path::Path::new("/sys/class/drm").exists() {
+                let pci = gpu_monitor.primary_gpu().map(|g| g.pci_address.clone());
+                match gpu::GpuSampler::spawn(pci) {
+                    Ok(sampler) => {
+                        info!("GPU sampler: bottleneck feedback enabled");
+                        Some(sampler)
+                    }
+                    Err(e) => {
+                        warn!("Failed to start GPU sampler: {}", e);
+                        None
+                    }
+                }
+            } else {
+                None
+            };
+
         // Initialize EPP manager for frequency hints
         let mut epp_manager = pbo::EppManager::new(topology.nr_cpus);
         epp_manager.save_original(topology.nr_cpus);
@@ -366,6 +430,14 @@ impl<'a> Scheduler<'a> {
             );
         }
 
+        // Check for BPF Arena support (stats plane shared memory)
+        let arena_status = arena::ArenaStatus::check();
+        if arena_status.supported {
+            info!("BPF Arena: stats plane enabled");
+        } else {
+            debug!("BPF Arena: {}", arena_status.reason);
+        }
+
         // Build BPF skeleton
         let skel_builder = GhostbrewSkelBuilder::default();
         debug!("Opening BPF skeleton...");
@@ -374,6 +446,40 @@ impl<'a> Scheduler<'a> {
             .open(open_object)
             .context("Failed to open BPF skeleton")?;
 
+        // On kernels without BPF_MAP_TYPE_ARENA, skip creating the arena map;
+        // the BPF side guards all arena access behind arena_enabled.
+        if !arena_status.supported {
+            open_skel
+                .maps
+                .arena
+                .set_autocreate(false)
+                .context("Failed to disable arena map autocreate")?;
+        }
+
+        // The futex hooks are optional ("?" sections, autoload off): their
+        // fexit/fentry targets are internal kernel symbols that not every
+        // build exports, and loading against a kernel without them fails
+        // the whole object. Enable them only when the symbols exist.
+        let futex_hooks_available =
+            kallsyms_has_symbol("__futex_wait") && kallsyms_has_symbol("futex_wake");
+        if futex_hooks_available {
+            open_skel.progs.ghostbrew_futex_wait.set_autoload(true);
+            open_skel
+                .progs
+                .ghostbrew_futex_wait_entry
+                .set_autoload(true);
+            open_skel.progs.ghostbrew_futex_wake.set_autoload(true);
+        } else {
+            info!("Kernel does not export futex symbols - futex awareness disabled");
+        }
+
+        // Thread Director / HFI capability feedback for P/E-core placement
+        let hfi_caps = if topology.is_intel_hybrid {
+            intel::read_hfi_caps(topology.nr_cpus)
+        } else {
+            None
+        };
+
         // Configure tunables via rodata
         {
             let rodata = open_skel
@@ -386,13 +492,16 @@ impl<'a> Scheduler<'a> {
             rodata.nr_ccds = topology.nr_ccds;
             rodata.vcache_ccd = topology.vcache_ccd.unwrap_or(0);
             rodata.smt_enabled = topology.smt_enabled;
+            rodata.smt_isolation = topology.smt_enabled && !args.no_smt_isolation;
             rodata.debug_mode = args.debug;
             // Intel hybrid support
             rodata.is_intel_hybrid = topology.is_intel_hybrid;
             rodata.nr_pcores = topology.pcore_cpus.len() as u32;
             rodata.nr_ecores = topology.ecore_cpus.len() as u32;
             rodata.ecore_offload_mode = ecore_offload_mode;
+            rodata.hfi_enabled = hfi_caps.is_some();
             // Zen 5 specific support
+            rodata.is_x3d = topology.is_x3d;
             rodata.zen_generation = topology.zen_generation.unwrap_or(0);
             rodata.freq_ccd = topology.freq_ccd.unwrap_or(0);
             rodata.asymmetric_ccd_boost = topology.asymmetric_ccd_boost;
@@ -400,6 +509,8 @@ impl<'a> Scheduler<'a> {
             // Default tunables (will be overwritten by runtime_tunables map after load)
             rodata.default_burst_threshold_ns = args.burst_threshold;
             rodata.default_slice_ns = args.slice_ns;
+            // Arena stats plane (requires kernel 6.18+)
+            rodata.arena_enabled = arena_status.supported;
         }
 
         // Load BPF program
@@ -416,10 +527,32 @@ impl<'a> Scheduler<'a> {
             Self::init_prefcore_rankings(&mut skel, &prefcore)?;
         }
 
+        // Publish Thread Director / HFI capabilities
+        if let Some(caps) = &hfi_caps {
+            debug!("Publishing Thread Director/HFI capabilities...");
+            Self::update_hfi_caps(&mut skel, caps)?;
+        }
+
         // Initialize runtime tunables map
         debug!("Initializing runtime tunables...");
         Self::init_runtime_tunables(&mut skel, &args, gaming_mode, work_mode)?;
 
+        // Warm handoff: during an in-place upgrade the outgoing daemon still
+        // owns the control socket (ours is bound later). Pull its
+        // classification state and tunables and apply them before attach, so
+        // the first scheduling decisions already see a warmed-up view instead
+        // of re-classifying everything from scratch.
+        let mut gaming_detector = gaming::GamingDetector::new();
+        let mut active_profiles = std::collections::HashMap::new();
+        if let Some(state) = control::fetch_handoff() {
+            Self::apply_handoff(
+                &mut skel,
+                &state,
+                &mut gaming_detector,
+                &mut active_profiles,
+            );
+        }
+
         // Attach struct_ops scheduler
         debug!("Attaching scheduler...");
         let struct_ops = skel
@@ -428,10 +561,31 @@ impl<'a> Scheduler<'a> {
             .attach_struct_ops()
             .context("Failed to attach struct_ops scheduler")?;
 
+        // The BPF init path allocates the arena stats page during attach and
+        // publishes its userspace pointer via the arena_stats_user global.
+        let arena_reader = if arena_status.supported {
+            let user_ptr = skel
+                .maps
+                .bss_data
+                .as_ref()
+                .map(|bss| bss.arena_stats_user)
+                .unwrap_or(0);
+            let reader = unsafe { arena::ArenaStatsReader::from_user_ptr(user_ptr) };
+            if reader.is_some() {
+                info!("Arena stats plane mapped (zero-syscall stats reads)");
+            } else {
+                warn!("Arena stats plane unavailable, falling back to map lookups");
+            }
+            reader
+        } else {
+            None
+        };
+
         info!("GhostBrew scheduler attached successfully");
         info!(
-            "  Per-CCD/Cluster DSQs: {} (IDs 1-{})",
-            topology.nr_ccds, topology.nr_ccds
+            "  Per-CCD/Cluster DSQs: {} ({} CCDs x 3 priority tiers)",
+            topology.nr_ccds * 3,
+            topology.nr_ccds
         );
         if topology.is_intel_hybrid {
             info!(
@@ -446,6 +600,9 @@ impl<'a> Scheduler<'a> {
                 _ => "unknown",
             };
             info!("  E-core offload: {}", mode_str);
+            if hfi_caps.is_some() {
+                info!("  Thread Director/HFI: live capability feedback enabled");
+            }
         } else {
             info!("  V-Cache CCD: {}", topology.vcache_ccd.unwrap_or(0));
             // Zen 5 specific info
@@ -487,15 +644,70 @@ impl<'a> Scheduler<'a> {
             warn!("Failed to initialize control interface: {}", e);
         }
 
+        // Start the flight recorder if requested (raw event capture for
+        // offline analysis; disables per-event log formatting)
+        let flight_recorder = match args.record_events.as_ref() {
+            Some(path) => match recorder::FlightRecorder::create(path) {
+                Ok(r) => Some(Arc::new(r)),
+                Err(e) => {
+                    warn!("Failed to start flight recorder: {} - using log output", e);
+                    None
+                }
+            },
+            None => None,
+        };
+
         // Initialize event handler for ringbuf
-        let event_handler = Arc::new(events::EventHandler::new(args.verbose || args.debug));
+        let event_handler = Arc::new(events::EventHandler::new(
+            args.verbose || args.debug,
+            flight_recorder,
+        ));
+
+        // Attach the exec tracepoint for event-driven gaming detection.
+        // Without it we fall back to full /proc scans every stats interval.
+        let exec_link = match skel.progs.ghostbrew_process_exec.attach() {
+            Ok(link) => {
+                info!("Exec notifications attached (event-driven gaming detection)");
+                Some(link)
+            }
+            Err(e) => {
+                warn!(
+                    "Failed to attach exec tracepoint: {} - falling back to periodic /proc scans",
+                    e
+                );
+                None
+            }
+        };
+
+        // Attach the futex hooks for lock-holder tracking and the
+        // priority-inheritance fast path (gaming waiter promotes holder).
+        let mut futex_links = Vec::new();
+        if futex_hooks_available {
+            let results = [
+                ("futex_wait", skel.progs.ghostbrew_futex_wait.attach()),
+                (
+                    "futex_wait_entry",
+                    skel.progs.ghostbrew_futex_wait_entry.attach(),
+                ),
+                ("futex_wake", skel.progs.ghostbrew_futex_wake.attach()),
+            ];
+            for (name, result) in results {
+                match result {
+                    Ok(link) => futex_links.push(link),
+                    Err(e) => warn!("Failed to attach {} hook: {}", name, e),
+                }
+            }
+            if futex_links.len() == 3 {
+                info!("Futex priority-inheritance hooks attached");
+            }
+        }
 
         Ok(Self {
             skel,
             struct_ops: Some(struct_ops),
             args,
             topology,
-            gaming_detector: gaming::GamingDetector::new(),
+            gaming_detector,
             prefcore,
             gpu_monitor,
             epp_manager,
@@ -505,10 +717,19 @@ impl<'a> Scheduler<'a> {
             config,
             profile_manager,
             vcache_controller,
-            active_profiles: std::collections::HashMap::new(),
+            active_profiles,
             mangohud_exporter,
             control_interface,
             event_handler,
+            arena_reader,
+            exec_link,
+            futex_links,
+            hfi_caps,
+            boost_sampler,
+            gpu_sampler,
+            gpu_bottleneck: gpu::GpuBottleneck::default(),
+            l3_sampler: l3miss::L3MissSampler::new(),
+            batch_cache_score: None,
         })
     }
 
@@ -593,6 +814,71 @@ impl<'a> Scheduler<'a> {
         Ok(())
     }
 
+    /// Write per-CPU Thread Director/HFI capabilities into the BPF map
+    fn update_hfi_caps(skel: &mut GhostbrewSkel, caps: &[intel::HfiCap]) -> Result<()> {
+        for (cpu, cap) in caps.iter().enumerate() {
+            let key = (cpu as u32).to_ne_bytes();
+            let mut value = [0u8; 8];
+            value[..4].copy_from_slice(&cap.perf_cap.to_ne_bytes());
+            value[4..].copy_from_slice(&cap.eff_cap.to_ne_bytes());
+
+            skel.maps
+                .cpu_hfi_caps
+                .update(&key, &value, libbpf_rs::MapFlags::ANY)
+                .with_context(|| format!("Failed to update cpu_hfi_caps for CPU {}", cpu))?;
+        }
+
+        debug!("Published HFI capabilities for {} CPUs", caps.len());
+        Ok(())
+    }
+
+    /// Re-read hardware feedback and republish when the capabilities moved
+    /// (thermal derating, favored-core shifts)
+    fn refresh_hfi_caps(&mut self) {
+        let Some(last) = &self.hfi_caps else { return };
+        let Some(fresh) = intel::read_hfi_caps(self.topology.nr_cpus) else {
+            return;
+        };
+        if fresh == *last {
+            return;
+        }
+
+        if let Err(e) = Self::update_hfi_caps(&mut self.skel, &fresh) {
+            debug!("Failed to refresh HFI capabilities: {}", e);
+            return;
+        }
+        self.hfi_caps = Some(fresh);
+    }
+
+    /// Sample per-core effective frequency and rewrite the BPF prefcore
+    /// rankings when sustained thermals shift which cores actually boost
+    fn update_prefcore_rankings(&mut self) {
+        let Some(sampler) = self.boost_sampler.as_mut() else {
+            return;
+        };
+        sampler.sample();
+        let Some(rankings) = sampler.rerank() else {
+            return;
+        };
+
+        for (cpu, &ranking) in rankings.iter().enumerate() {
+            let key = (cpu as u32).to_ne_bytes();
+            let value = ranking.to_ne_bytes();
+
+            if let Err(e) =
+                self.skel
+                    .maps
+                    .prefcore_rankings
+                    .update(&key, &value, libbpf_rs::MapFlags::ANY)
+            {
+                debug!("Failed to update prefcore ranking for CPU {}: {}", cpu, e);
+                return;
+            }
+        }
+
+        debug!("Prefcore rankings re-ranked from boost telemetry");
+    }
+
     /// Initialize runtime tunables in BPF map
     fn init_runtime_tunables(
         skel: &mut GhostbrewSkel,
@@ -601,7 +887,8 @@ impl<'a> Scheduler<'a> {
         work_mode: bool,
     ) -> Result<()> {
         // Struct layout must match BPF runtime_tunables:
-        // u64 burst_threshold_ns, u64 slice_ns, u8 gaming_mode, u8 work_mode, u8[6] pad
+        // u64 burst_threshold_ns, u64 slice_ns, u8 gaming_mode, u8 work_mode,
+        // u8 power_save_mode, u8 tickless_enabled, u8 gpu_bound_mode, u8[3] pad
         let mut value = [0u8; 24];
         value[0..8].copy_from_slice(&args.burst_threshold.to_ne_bytes());
         value[8..16].copy_from_slice(&args.slice_ns.to_ne_bytes());
@@ -659,12 +946,15 @@ impl<'a> Scheduler<'a> {
             work = v;
         }
 
-        // Write back
+        // Write back, preserving power_save/tickless/gpu_bound (bytes 18-20)
         let mut value = [0u8; 24];
         value[0..8].copy_from_slice(&burst.to_ne_bytes());
         value[8..16].copy_from_slice(&slice.to_ne_bytes());
         value[16] = if gaming { 1 } else { 0 };
         value[17] = if work { 1 } else { 0 };
+        if current.len() >= 21 {
+            value[18..21].copy_from_slice(&current[18..21]);
+        }
 
         self.skel
             .maps
@@ -679,6 +969,131 @@ impl<'a> Scheduler<'a> {
         Ok(())
     }
 
+    /// Update only gpu_bound_mode (byte 20) in runtime_tunables
+    fn set_gpu_bound_mode(&mut self, mode: u8) -> Result<()> {
+        let key = 0u32.to_ne_bytes();
+        let current = self
+            .skel
+            .maps
+            .runtime_tunables
+            .lookup(&key, libbpf_rs::MapFlags::ANY)?
+            .ok_or_else(|| anyhow::anyhow!("runtime_tunables map empty"))?;
+
+        let mut value = [0u8; 24];
+        let len = current.len().min(24);
+        value[..len].copy_from_slice(&current[..len]);
+        value[20] = mode;
+
+        self.skel
+            .maps
+            .runtime_tunables
+            .update(&key, &value, libbpf_rs::MapFlags::ANY)
+            .context("Failed to update gpu_bound_mode")?;
+        Ok(())
+    }
+
+    /// Apply a predecessor's warm-handoff state before struct_ops attach
+    ///
+    /// Seeds the gaming detector and the gaming/VM/container PID maps with
+    /// the outgoing daemon's classifications (PIDs that exited during the
+    /// handoff window are dropped) and carries its runtime tunables over
+    /// the init defaults, profile adjustments included. Applied before
+    /// attach so there is no re-classification cold start across upgrades.
+    fn apply_handoff(
+        skel: &mut GhostbrewSkel,
+        state: &control::HandoffState,
+        detector: &mut gaming::GamingDetector,
+        active_profiles: &mut std::collections::HashMap<u32, String>,
+    ) {
+        let alive = |pid: u32| std::path::Path::new(&format!("/proc/{}", pid)).exists();
+
+        let accepted = detector.restore(&state.gaming_pids);
+        let mut diff = batch::PidMapDiff::new();
+        for &(pid, class) in &accepted {
+            diff.update(pid, class);
+        }
+        if !diff.is_empty() {
+            diff.commit(&skel.maps.gaming_pids, "gaming_pids");
+        }
+
+        // VM/container classifications are owned by their monitors, which
+        // rescan on the first stats interval and correct any drift; the
+        // handoff just covers the window until then.
+        let mut vm_diff = batch::PidMapDiff::new();
+        for &(pid, class) in state.vm_pids.iter().filter(|&&(pid, _)| alive(pid)) {
+            vm_diff.update(pid, class);
+        }
+        if !vm_diff.is_empty() {
+            vm_diff.commit(&skel.maps.vm_vcpu_pids, "vm_vcpu_pids");
+        }
+
+        let mut container_diff = batch::PidMapDiff::new();
+        for &(pid, class) in state.container_pids.iter().filter(|&&(pid, _)| alive(pid)) {
+            container_diff.update(pid, class);
+        }
+        if !container_diff.is_empty() {
+            container_diff.commit(&skel.maps.container_pids, "container_pids");
+        }
+
+        for (pid, profile_name) in &state.active_profiles {
+            if alive(*pid) {
+                active_profiles.insert(*pid, profile_name.clone());
+            }
+        }
+
+        if state.tunables.len() == 24 {
+            let key = 0u32.to_ne_bytes();
+            if let Err(e) =
+                skel.maps
+                    .runtime_tunables
+                    .update(&key, &state.tunables, libbpf_rs::MapFlags::ANY)
+            {
+                warn!("Failed to carry over handoff tunables: {}", e);
+            }
+        }
+
+        info!(
+            "Warm handoff applied: {} classified PIDs, {} VM vCPUs, {} container PIDs, {} active profiles",
+            accepted.len(),
+            state.vm_pids.len(),
+            state.container_pids.len(),
+            active_profiles.len()
+        );
+    }
+
+    /// Push the sampled GPU bottleneck verdict into the BPF tunables
+    ///
+    /// While GPU-bound, the BPF side skips V-Cache preempt kicks and widens
+    /// batch slices - preemption aggression buys no frame time when the
+    /// render pipeline is waiting on the GPU.
+    fn update_gpu_bottleneck(&mut self) {
+        let Some(sampler) = &self.gpu_sampler else {
+            return;
+        };
+
+        let verdict = sampler.bottleneck();
+        if verdict == self.gpu_bottleneck {
+            return;
+        }
+
+        if let Err(e) = self.set_gpu_bound_mode(verdict.as_bpf_mode()) {
+            debug!("Failed to update gpu_bound_mode: {}", e);
+            return;
+        }
+
+        info!(
+            "GPU bottleneck: {} -> {} ({})",
+            self.gpu_bottleneck,
+            verdict,
+            if verdict == gpu::GpuBottleneck::GpuBound {
+                "relaxing gaming preemption"
+            } else {
+                "normal preemption"
+            }
+        );
+        self.gpu_bottleneck = verdict;
+    }
+
     /// Apply profile-specific tunables to BPF
     fn apply_profile_tunables_direct(
         &mut self,
@@ -745,43 +1160,63 @@ impl<'a> Scheduler<'a> {
 
         info!("Event streaming enabled (ringbuf)");
 
-        // Initial gaming PID scan
+        // Initial gaming PID scan - seeds state for processes that exec'd
+        // before we attached; afterwards exec events keep it current.
         self.update_gaming_pids();
 
         // Initial cgroup classification population
         self.update_cgroup_classes();
 
-        // Main loop
+        // Hot/slow split: ringbuf consumption runs on its own thread so a
+        // slow procfs/cgroup rescan can never stall it into dropping
+        // events (drop counters during container churn used to show
+        // exactly that). This loop stays the control plane: a 100ms tick
+        // serving exec classification, the control socket and the
+        // periodic scanners.
+        let events_map = libbpf_rs::MapHandle::try_from(&self.skel.maps.events)
+            .context("Failed to dup events map fd")?;
+        let event_thread =
+            events::spawn_event_thread(events_map, self.event_handler.clone(), shutdown.clone())
+                .context("Failed to spawn event consumer thread")?;
+
+        // Control-plane loop
         let stats_interval = Duration::from_secs(self.args.stats_interval);
         let poll_interval = Duration::from_millis(100);
         let mut last_stats = Instant::now();
 
         while !shutdown.load(Ordering::Relaxed) {
-            // Poll ringbuf for events (100ms timeout, non-blocking)
-            // Build ringbuf in each iteration to avoid lifetime issues
-            {
-                if let Ok(ringbuf) =
-                    events::build_ringbuf(&self.skel.maps.events, self.event_handler.clone())
-                    && let Err(e) = events::poll_events(&ringbuf, poll_interval)
-                {
-                    debug!("Ringbuf poll error: {}", e);
-                }
-            }
+            std::thread::sleep(poll_interval);
+
+            // Classify freshly exec'd PIDs queued by the tracepoint
+            self.process_exec_events();
+
+            // Serve control socket clients every tick so tunable pushes and
+            // stats queries are answered immediately, not on the stats interval
+            self.poll_control_socket();
 
             // Check if it's time for periodic tasks
             if last_stats.elapsed() < stats_interval {
                 continue;
             }
             last_stats = Instant::now();
+            let scan_started = Instant::now();
 
-            // Scan for gaming PIDs periodically
-            self.update_gaming_pids();
+            // With exec events driving additions, periodic work reduces to
+            // pruning dead PIDs; without them, keep the full /proc rescan.
+            if self.exec_link.is_some() {
+                self.prune_gaming_pids();
+            } else {
+                self.update_gaming_pids();
+            }
 
             // Update GPU power states
             if self.gpu_monitor.update_power_states() {
                 debug!("GPU power state changed");
             }
 
+            // Push the sampled GPU bottleneck verdict into BPF tunables
+            self.update_gpu_bottleneck();
+
             // Scan for VMs and update BPF map
             self.update_vm_pids();
 
@@ -794,6 +1229,15 @@ impl<'a> Scheduler<'a> {
             // Apply EPP hints based on workload
             self.update_epp_hints();
 
+            // Follow Thread Director/HFI capability changes
+            self.refresh_hfi_caps();
+
+            // Re-rank prefcore from boost-residency telemetry
+            self.update_prefcore_rankings();
+
+            // Sample L3 miss ratios into cache-sensitivity scores
+            self.update_cache_scores();
+
             // Poll V-Cache controller for mode changes (ghost-vcache integration)
             self.poll_vcache_mode();
 
@@ -807,10 +1251,23 @@ impl<'a> Scheduler<'a> {
 
             // Export to MangoHud CSV if enabled
             self.export_mangohud_stats();
+
+            // Scanner latency now only defers scan freshness (events keep
+            // flowing), but a pathological walk is still worth seeing
+            let scan_elapsed = scan_started.elapsed();
+            if scan_elapsed > Duration::from_millis(500) {
+                debug!(
+                    "Periodic scanners took {}ms this interval",
+                    scan_elapsed.as_millis()
+                );
+            }
         }
 
         info!("GhostBrew shutting down...");
 
+        // Stop the event consumer (it re-checks shutdown every poll timeout)
+        let _ = event_thread.join();
+
         // Restore original EPP values
         self.epp_manager.restore_original();
 
@@ -820,58 +1277,23 @@ impl<'a> Scheduler<'a> {
         Ok(())
     }
 
+    /// Invalidate cached in-BPF task classifications
+    ///
+    /// Bumps the generation counter checked by is_gaming_task whenever the
+    /// classification inputs (gaming/VM/container PID maps, cgroup classes)
+    /// change, so tasks re-run the comm/parent-chain checks exactly once.
+    fn bump_classification_gen(&mut self) {
+        if let Some(bss) = self.skel.maps.bss_data.as_mut() {
+            bss.classification_gen = bss.classification_gen.wrapping_add(1);
+        }
+    }
+
     /// Update the gaming_pids BPF map with detected gaming processes
     fn update_gaming_pids(&mut self) {
         match self.gaming_detector.scan_changes() {
             Ok((new_pids, removed_pids)) => {
-                // Add new gaming PIDs
-                for (pid, class) in &new_pids {
-                    let key = pid.to_ne_bytes();
-                    let value = class.to_ne_bytes();
-                    if let Err(e) =
-                        self.skel
-                            .maps
-                            .gaming_pids
-                            .update(&key, &value, libbpf_rs::MapFlags::ANY)
-                    {
-                        debug!("Failed to add gaming PID {}: {}", pid, e);
-                    }
-
-                    // Check for profile match
-                    if let Some(exe_name) = gaming::get_exe_name(*pid) {
-                        // Clone profile data to avoid borrow conflict
-                        let profile_data = self
-                            .profile_manager
-                            .match_process(&exe_name, None)
-                            .map(|p| (p.name.clone(), p.tunables.clone()));
-
-                        if let Some((profile_name, tunables)) = profile_data {
-                            info!(
-                                "Matched profile '{}' for {} (PID {})",
-                                profile_name, exe_name, pid
-                            );
-                            self.active_profiles.insert(*pid, profile_name.clone());
-
-                            // Apply profile tunables to BPF
-                            self.apply_profile_tunables_direct(&profile_name, &tunables);
-                        }
-                    }
-                }
-
-                // Remove old PIDs
-                for pid in &removed_pids {
-                    let key = pid.to_ne_bytes();
-                    let _ = self.skel.maps.gaming_pids.delete(&key);
-                    // Clean up active profiles
-                    if let Some(profile_name) = self.active_profiles.remove(pid) {
-                        debug!("Removed profile '{}' for PID {}", profile_name, pid);
-
-                        // If no more profiled games, revert to default tunables
-                        if self.active_profiles.is_empty() {
-                            self.revert_to_default_tunables();
-                        }
-                    }
-                }
+                self.apply_new_gaming_pids(&new_pids);
+                self.apply_removed_gaming_pids(&removed_pids);
 
                 let (gaming, batch, ai) = self.gaming_detector.counts();
                 if gaming > 0 || batch > 0 || ai > 0 {
@@ -887,6 +1309,91 @@ impl<'a> Scheduler<'a> {
         }
     }
 
+    /// Push newly classified PIDs into the gaming_pids map and match profiles
+    fn apply_new_gaming_pids(&mut self, new_pids: &[(u32, u32)]) {
+        // Commit all map changes in one batch before the profile pass
+        let mut diff = batch::PidMapDiff::new();
+        for &(pid, class) in new_pids {
+            diff.update(pid, class);
+        }
+        if !diff.is_empty() {
+            diff.commit(&self.skel.maps.gaming_pids, "gaming_pids");
+            self.bump_classification_gen();
+        }
+
+        for (pid, _class) in new_pids {
+            // Check for profile match
+            if let Some(exe_name) = gaming::get_exe_name(*pid) {
+                // Clone profile data to avoid borrow conflict
+                let profile_data = self
+                    .profile_manager
+                    .match_process_for_pid(*pid, &exe_name, None)
+                    .map(|p| (p.name.clone(), p.tunables.clone()));
+
+                if let Some((profile_name, tunables)) = profile_data {
+                    info!(
+                        "Matched profile '{}' for {} (PID {})",
+                        profile_name, exe_name, pid
+                    );
+                    self.active_profiles.insert(*pid, profile_name.clone());
+
+                    // Apply profile tunables to BPF
+                    self.apply_profile_tunables_direct(&profile_name, &tunables);
+                }
+            }
+        }
+    }
+
+    /// Remove exited PIDs from the gaming_pids map and clean up profiles
+    fn apply_removed_gaming_pids(&mut self, removed_pids: &[u32]) {
+        let mut diff = batch::PidMapDiff::new();
+        for &pid in removed_pids {
+            diff.delete(pid);
+        }
+        if !diff.is_empty() {
+            diff.commit(&self.skel.maps.gaming_pids, "gaming_pids");
+            self.bump_classification_gen();
+        }
+
+        for pid in removed_pids {
+            self.profile_manager.forget_pid(*pid);
+
+            // Clean up active profiles
+            if let Some(profile_name) = self.active_profiles.remove(pid) {
+                debug!("Removed profile '{}' for PID {}", profile_name, pid);
+
+                // If no more profiled games, revert to default tunables
+                if self.active_profiles.is_empty() {
+                    self.revert_to_default_tunables();
+                }
+            }
+        }
+    }
+
+    /// Classify PIDs reported by the exec tracepoint (every poll iteration)
+    fn process_exec_events(&mut self) {
+        if self.exec_link.is_none() {
+            return;
+        }
+
+        let mut pids = Vec::new();
+        while let Some(pid) = self.event_handler.exec_pids.pop() {
+            pids.push(pid);
+        }
+        if pids.is_empty() {
+            return;
+        }
+
+        let new_pids = self.gaming_detector.classify_exec_pids(&pids);
+        self.apply_new_gaming_pids(&new_pids);
+    }
+
+    /// Drop tracked PIDs whose processes exited (cheap liveness check)
+    fn prune_gaming_pids(&mut self) {
+        let removed = self.gaming_detector.prune_dead_pids();
+        self.apply_removed_gaming_pids(&removed);
+    }
+
     /// Update VM vCPU PIDs in BPF map
     fn update_vm_pids(&mut self) {
         match self.vm_monitor.rescan() {
@@ -901,28 +1408,25 @@ impl<'a> Scheduler<'a> {
                     );
                 }
 
-                // Update BPF map with all vCPU workloads
+                // Stage all vCPU workload changes and commit in one batch
+                let mut diff = batch::PidMapDiff::new();
                 let workloads = self.vm_monitor.get_vcpu_workloads();
                 for (pid, workload_type) in workloads {
-                    let key = pid.to_ne_bytes();
                     let class = match workload_type {
                         vm::VmWorkloadType::Gaming => 6u32,  // WORKLOAD_VM_GAMING
                         vm::VmWorkloadType::Dev => 5u32,     // WORKLOAD_VM_DEV
                         vm::VmWorkloadType::Ai => 4u32,      // WORKLOAD_AI
                         vm::VmWorkloadType::Unknown => 5u32, // Default to dev
                     };
-                    let value = class.to_ne_bytes();
-                    let _ =
-                        self.skel
-                            .maps
-                            .vm_vcpu_pids
-                            .update(&key, &value, libbpf_rs::MapFlags::ANY);
+                    diff.update(pid, class);
                 }
-
-                // Remove old PIDs
+                let changed = !new_vms.is_empty() || !removed_pids.is_empty();
                 for pid in removed_pids {
-                    let key = pid.to_ne_bytes();
-                    let _ = self.skel.maps.vm_vcpu_pids.delete(&key);
+                    diff.delete(pid);
+                }
+                diff.commit(&self.skel.maps.vm_vcpu_pids, "vm_vcpu_pids");
+                if changed {
+                    self.bump_classification_gen();
                 }
             }
             Err(e) => {
@@ -946,22 +1450,21 @@ impl<'a> Scheduler<'a> {
                     );
                 }
 
-                // Update BPF map with all container PIDs
+                // Stage all container PID changes and commit in one batch
+                let mut diff = batch::PidMapDiff::new();
                 let pids = self.container_monitor.all_pids();
                 for (pid, workload_type) in pids {
-                    let key = pid.to_ne_bytes();
                     let class = match workload_type {
                         container::ContainerWorkloadType::Ai => 4u32, // WORKLOAD_AI
                         container::ContainerWorkloadType::Gaming => 1u32, // WORKLOAD_GAMING
                         container::ContainerWorkloadType::Compute => 3u32, // WORKLOAD_BATCH
                         container::ContainerWorkloadType::General => 7u32, // WORKLOAD_CONTAINER
                     };
-                    let value = class.to_ne_bytes();
-                    let _ = self.skel.maps.container_pids.update(
-                        &key,
-                        &value,
-                        libbpf_rs::MapFlags::ANY,
-                    );
+                    diff.update(pid, class);
+                }
+                diff.commit(&self.skel.maps.container_pids, "container_pids");
+                if !new_containers.is_empty() || !removed_ids.is_empty() {
+                    self.bump_classification_gen();
                 }
 
                 // Log removed containers
@@ -975,6 +1478,49 @@ impl<'a> Scheduler<'a> {
         }
     }
 
+    /// Sample per-task L3 miss ratios and publish cache-sensitivity scores
+    ///
+    /// Tracks every PID the gaming detector classified - gaming and batch
+    /// alike, since both sides of the V-Cache placement decision need
+    /// measuring - pushes changed scores into the task_cache_scores map,
+    /// and aggregates the batch cohort's average miss ratio for the
+    /// V-Cache mode switcher.
+    fn update_cache_scores(&mut self) {
+        if !self.l3_sampler.is_available() {
+            return;
+        }
+
+        let classified = self.gaming_detector.snapshot();
+        let tracked: std::collections::HashSet<u32> =
+            classified.iter().map(|&(pid, _)| pid).collect();
+
+        for pid in self.l3_sampler.retain_tracked(&tracked) {
+            let _ = self.skel.maps.task_cache_scores.delete(&pid.to_ne_bytes());
+        }
+        for &pid in &tracked {
+            self.l3_sampler.track(pid);
+        }
+
+        for (pid, score) in self.l3_sampler.sample() {
+            let _ = self.skel.maps.task_cache_scores.update(
+                &pid.to_ne_bytes(),
+                &score.to_ne_bytes(),
+                libbpf_rs::MapFlags::ANY,
+            );
+        }
+
+        let batch_scores: Vec<u32> = classified
+            .iter()
+            .filter(|&&(_, class)| class == gaming::WORKLOAD_BATCH)
+            .filter_map(|&(pid, _)| self.l3_sampler.score(pid))
+            .collect();
+        self.batch_cache_score = if batch_scores.is_empty() {
+            None
+        } else {
+            Some(batch_scores.iter().sum::<u32>() / batch_scores.len() as u32)
+        };
+    }
+
     /// Update cgroup classifications in BPF map
     fn update_cgroup_classes(&mut self) {
         match self.cgroup_monitor.rescan() {
@@ -999,10 +1545,28 @@ impl<'a> Scheduler<'a> {
                     );
                 }
 
-                // Remove old cgroups from map
+                // Update proportional-share weights (cgroup v2 cpu.weight)
+                for (&cgroup_id, &weight) in self.cgroup_monitor.get_weights() {
+                    let key = cgroup_id.to_ne_bytes();
+                    let value = weight.to_ne_bytes();
+                    let _ = self.skel.maps.cgroup_weights.update(
+                        &key,
+                        &value,
+                        libbpf_rs::MapFlags::ANY,
+                    );
+                }
+
+                // Remove old cgroups from the maps, including any accrued
+                // vruntime so a reused cgroup ID starts clean
+                let changed = !new_cgroups.is_empty() || !removed_ids.is_empty();
                 for cgroup_id in removed_ids {
                     let key = cgroup_id.to_ne_bytes();
                     let _ = self.skel.maps.cgroup_classes.delete(&key);
+                    let _ = self.skel.maps.cgroup_weights.delete(&key);
+                    let _ = self.skel.maps.cgroup_vtimes.delete(&key);
+                }
+                if changed {
+                    self.bump_classification_gen();
                 }
             }
             Err(e) => {
@@ -1072,7 +1636,9 @@ impl<'a> Scheduler<'a> {
             let nr_gaming = bss.nr_gaming_tasks;
             let nr_batch = bss.nr_enqueued.saturating_sub(nr_gaming); // Rough batch estimate
 
-            if let Some(target_mode) = self.vcache_controller.evaluate_switch(nr_gaming, nr_batch)
+            if let Some(target_mode) =
+                self.vcache_controller
+                    .evaluate_switch(nr_gaming, nr_batch, self.batch_cache_score)
                 && let Err(e) = self.vcache_controller.request_mode(target_mode)
             {
                 warn!("Failed to switch V-Cache mode: {}", e);
@@ -1085,35 +1651,193 @@ impl<'a> Scheduler<'a> {
         let commands = self.control_interface.poll_commands();
 
         for cmd in commands {
-            match cmd {
-                control::ControlCommand::SetBurstThreshold(ns) => {
-                    info!("Control: Setting burst_threshold_ns={}", ns);
-                    if let Err(e) = self.update_runtime_tunables(Some(ns), None, None, None) {
-                        warn!("Failed to apply burst threshold: {}", e);
-                    }
-                }
-                control::ControlCommand::SetSlice(ns) => {
-                    info!("Control: Setting slice_ns={}", ns);
-                    if let Err(e) = self.update_runtime_tunables(None, Some(ns), None, None) {
-                        warn!("Failed to apply slice: {}", e);
+            self.apply_control_command(cmd);
+        }
+    }
+
+    /// Apply a single control command; returns false if it failed
+    fn apply_control_command(&mut self, cmd: control::ControlCommand) -> bool {
+        let result = match cmd {
+            control::ControlCommand::SetBurstThreshold(ns) => {
+                info!("Control: Setting burst_threshold_ns={}", ns);
+                self.update_runtime_tunables(Some(ns), None, None, None)
+            }
+            control::ControlCommand::SetSlice(ns) => {
+                info!("Control: Setting slice_ns={}", ns);
+                self.update_runtime_tunables(None, Some(ns), None, None)
+            }
+            control::ControlCommand::GamingMode(enabled) => {
+                info!("Control: Setting gaming_mode={}", enabled);
+                self.update_runtime_tunables(None, None, Some(enabled), None)
+            }
+            control::ControlCommand::WorkMode(enabled) => {
+                info!("Control: Setting work_mode={}", enabled);
+                self.update_runtime_tunables(None, None, None, Some(enabled))
+            }
+        };
+
+        if let Err(e) = result {
+            warn!("Failed to apply control command: {}", e);
+            return false;
+        }
+        true
+    }
+
+    /// Serve binary control socket clients (tunable pushes and GET_STATS)
+    fn poll_control_socket(&mut self) {
+        // Collect first: responding needs &mut self for tunable application
+        let clients = self.control_interface.poll_socket();
+
+        for client in clients {
+            match client.request {
+                control::SocketRequest::Command(ref cmd) => {
+                    if self.apply_control_command(cmd.clone()) {
+                        client.respond_ok(&[]);
+                    } else {
+                        client.respond_err();
                     }
                 }
-                control::ControlCommand::GamingMode(enabled) => {
-                    info!("Control: Setting gaming_mode={}", enabled);
-                    if let Err(e) = self.update_runtime_tunables(None, None, Some(enabled), None) {
-                        warn!("Failed to apply gaming mode: {}", e);
-                    }
+                control::SocketRequest::GetStats => {
+                    let snapshot = self.stats_snapshot();
+                    client.respond_ok(&snapshot);
                 }
-                control::ControlCommand::WorkMode(enabled) => {
-                    info!("Control: Setting work_mode={}", enabled);
-                    if let Err(e) = self.update_runtime_tunables(None, None, None, Some(enabled)) {
-                        warn!("Failed to apply work mode: {}", e);
+                control::SocketRequest::GetHandoff => match self.handoff_snapshot() {
+                    Ok(payload) => client.respond_ok(&payload),
+                    Err(e) => {
+                        warn!("Failed to build handoff snapshot: {}", e);
+                        client.respond_err();
                     }
-                }
+                },
             }
         }
     }
 
+    /// Build the fixed-layout binary stats snapshot served over the control
+    /// socket (layout documented in control.rs)
+    fn stats_snapshot(&self) -> Vec<u8> {
+        const MAX_SNAPSHOT_CCDS: usize = 8;
+        let mut buf = Vec::with_capacity(16 + (25 + 16 + MAX_SNAPSHOT_CCDS * 2) * 8);
+
+        buf.extend_from_slice(&control::STATS_MAGIC.to_le_bytes());
+        buf.extend_from_slice(&control::STATS_VERSION.to_le_bytes());
+        buf.extend_from_slice(&self.topology.nr_ccds.to_le_bytes());
+        buf.extend_from_slice(&0u32.to_le_bytes()); // reserved
+
+        if let Some(bss) = self.skel.maps.bss_data.as_ref() {
+            for counter in [
+                bss.nr_enqueued,
+                bss.nr_dispatched,
+                bss.nr_direct_dispatched,
+                bss.nr_gaming_tasks,
+                bss.nr_interactive_tasks,
+                bss.nr_vcache_migrations,
+                bss.nr_ccd_local,
+                bss.nr_ccd_cross,
+                bss.nr_ccd_balance_migrations,
+                bss.nr_smt_idle_picks,
+                bss.nr_idle_mask_picks,
+                bss.nr_compaction_overflows,
+                bss.nr_preempt_kicks,
+                bss.nr_futex_boosts,
+                bss.nr_futex_pi_boosts,
+                bss.nr_frame_paced,
+                bss.latency_sum_ns,
+                bss.latency_count,
+                bss.latency_min_ns,
+                bss.latency_max_ns,
+                bss.gaming_latency_sum_ns,
+                bss.gaming_latency_sum_sq,
+                bss.gaming_latency_count,
+                bss.gaming_late_frames,
+                bss.gaming_preempted,
+            ] {
+                buf.extend_from_slice(&counter.to_le_bytes());
+            }
+        } else {
+            buf.extend(std::iter::repeat_n(0u8, 25 * 8));
+        }
+
+        for bucket in self.read_gaming_latency_hist() {
+            buf.extend_from_slice(&bucket.to_le_bytes());
+        }
+
+        // Fixed 8 CCD slots; entries beyond nr_ccds stay zero
+        let mut ccd_loads = [[0u64; 2]; MAX_SNAPSHOT_CCDS];
+        for (ccd, nr_gaming, nr_tasks) in self.read_ccd_loads() {
+            if (ccd as usize) < MAX_SNAPSHOT_CCDS {
+                ccd_loads[ccd as usize] = [nr_tasks, nr_gaming];
+            }
+        }
+        for [nr_tasks, nr_gaming] in ccd_loads {
+            buf.extend_from_slice(&nr_tasks.to_le_bytes());
+            buf.extend_from_slice(&nr_gaming.to_le_bytes());
+        }
+
+        buf
+    }
+
+    /// Build the warm-handoff payload served over the control socket
+    ///
+    /// Mirrors what the monitors pushed into the BPF maps: gaming detector
+    /// PID sets, VM vCPU and container classifications (same class mapping
+    /// as update_vm_pids/update_container_pids), active profile matches,
+    /// and the live runtime_tunables bytes. An incoming daemon applies this
+    /// via apply_handoff before attaching its own struct_ops.
+    fn handoff_snapshot(&self) -> Result<Vec<u8>> {
+        let vm_pids = self
+            .vm_monitor
+            .get_vcpu_workloads()
+            .iter()
+            .map(|(&pid, workload_type)| {
+                let class = match workload_type {
+                    vm::VmWorkloadType::Gaming => 6u32,  // WORKLOAD_VM_GAMING
+                    vm::VmWorkloadType::Dev => 5u32,     // WORKLOAD_VM_DEV
+                    vm::VmWorkloadType::Ai => 4u32,      // WORKLOAD_AI
+                    vm::VmWorkloadType::Unknown => 5u32, // Default to dev
+                };
+                (pid, class)
+            })
+            .collect();
+
+        let container_pids = self
+            .container_monitor
+            .all_pids()
+            .into_iter()
+            .map(|(pid, workload_type)| {
+                let class = match workload_type {
+                    container::ContainerWorkloadType::Ai => 4u32, // WORKLOAD_AI
+                    container::ContainerWorkloadType::Gaming => 1u32, // WORKLOAD_GAMING
+                    container::ContainerWorkloadType::Compute => 3u32, // WORKLOAD_BATCH
+                    container::ContainerWorkloadType::General => 7u32, // WORKLOAD_CONTAINER
+                };
+                (pid, class)
+            })
+            .collect();
+
+        let key = 0u32.to_ne_bytes();
+        let tunables = self
+            .skel
+            .maps
+            .runtime_tunables
+            .lookup(&key, libbpf_rs::MapFlags::ANY)?
+            .unwrap_or_default();
+
+        let state = control::HandoffState {
+            version: control::HANDOFF_VERSION,
+            gaming_pids: self.gaming_detector.snapshot(),
+            vm_pids,
+            container_pids,
+            active_profiles: self
+                .active_profiles
+                .iter()
+                .map(|(&pid, name)| (pid, name.clone()))
+                .collect(),
+            tunables,
+        };
+
+        serde_json::to_vec(&state).context("Failed to serialize handoff state")
+    }
+
     fn print_stats(&self) {
         let Some(bss) = self.skel.maps.bss_data.as_ref() else {
             println!("--- GhostBrew Stats (unavailable) ---");
@@ -1122,8 +1846,8 @@ impl<'a> Scheduler<'a> {
         println!("--- GhostBrew Stats ---");
         println!("  Enqueued: {}", bss.nr_enqueued);
         println!(
-            "  Dispatched: {} (direct: {})",
-            bss.nr_dispatched, bss.nr_direct_dispatched
+            "  Dispatched: {} (direct: {}, pinned: {})",
+            bss.nr_dispatched, bss.nr_direct_dispatched, bss.nr_pinned_dispatches
         );
         println!(
             "  Modes: gaming={} work={}",
@@ -1153,9 +1877,48 @@ impl<'a> Scheduler<'a> {
             "  CCD local: {} | cross: {}",
             bss.nr_ccd_local, bss.nr_ccd_cross
         );
+        if bss.nr_ccd_balance_migrations > 0 {
+            println!(
+                "  CCD balance migrations: {}",
+                bss.nr_ccd_balance_migrations
+            );
+        }
+        if bss.nr_futex_pi_boosts > 0 {
+            println!("  Futex PI boosts: {}", bss.nr_futex_pi_boosts);
+        }
+        if bss.nr_events_aggregated > 0 {
+            println!("  Events aggregated: {}", bss.nr_events_aggregated);
+        }
         println!("  SMT idle picks: {}", bss.nr_smt_idle_picks);
+        if bss.nr_smt_isolations > 0 {
+            println!("  SMT batch isolations: {}", bss.nr_smt_isolations);
+        }
+        println!("  Idle mask picks: {}", bss.nr_idle_mask_picks);
         println!("  Compaction overflows: {}", bss.nr_compaction_overflows);
         println!("  Preempt kicks: {}", bss.nr_preempt_kicks);
+        if bss.nr_gpu_relaxed_kicks > 0 {
+            println!(
+                "  Preempt kicks skipped (GPU-bound): {}",
+                bss.nr_gpu_relaxed_kicks
+            );
+        }
+        if let Some(sampler) = &self.gpu_sampler
+            && let Some(util) = sampler.utilization()
+        {
+            println!("  GPU utilization: {}% ({})", util, sampler.bottleneck());
+        }
+        if bss.nr_busyloop_demotions > 0 {
+            println!(
+                "  Busyloop throttle: {} demoted, {} promoted back",
+                bss.nr_busyloop_demotions, bss.nr_busyloop_promotions
+            );
+        }
+        if bss.nr_cache_hot_promotions > 0 || bss.nr_cache_cold_demotions > 0 {
+            println!(
+                "  Cache-sensitivity overrides: {} granted V-Cache, {} revoked",
+                bss.nr_cache_hot_promotions, bss.nr_cache_cold_demotions
+            );
+        }
         // Scheduling latency stats
         let avg_latency_us = bss
             .latency_sum_ns
@@ -1203,6 +1966,9 @@ impl<'a> Scheduler<'a> {
                         late_pct, bss.gaming_preempted
                     );
                 }
+                if bss.nr_frame_paced > 0 {
+                    println!("  Frame-paced dispatches: {}", bss.nr_frame_paced);
+                }
             }
         }
         // Phase 4a stats
@@ -1225,6 +1991,8 @@ impl<'a> Scheduler<'a> {
             // Per-CCD load display
             self.print_ccd_loads();
         }
+        // Per-DSQ backlog depths and cross-CCD steal ages
+        self.print_dsq_stats();
         // Game profiles loaded
         if self.profile_manager.count() > 0 {
             println!("  Game profiles: {}", self.profile_manager.count());
@@ -1278,16 +2046,69 @@ impl<'a> Scheduler<'a> {
                 self.cgroup_monitor.gaming_count()
             );
         }
+        if bss.nr_cgroup_vtime_penalties > 0 {
+            println!(
+                "  Cgroup weight penalties: {}",
+                bss.nr_cgroup_vtime_penalties
+            );
+        }
         // Event streaming stats
         println!("  {}", self.event_handler.counters.summary());
         println!("---");
     }
 
-    /// Print per-CCD load statistics
-    fn print_ccd_loads(&self) {
-        let vcache_ccd = self.topology.vcache_ccd.unwrap_or(0);
-        let freq_ccd = self.topology.freq_ccd;
+    /// Read per-CCD loads, preferring the zero-syscall arena snapshot
+    /// Merge the per-CPU, per-class latency histograms at read time.
+    ///
+    /// Rows are indexed by priority class (PRIO_GAMING=0, PRIO_INTERACTIVE=1,
+    /// PRIO_BATCH=2), matching struct latency_hists on the BPF side.
+    fn read_latency_hists(&self) -> [[u64; arena::ARENA_HIST_BUCKETS]; 3] {
+        let mut merged = [[0u64; arena::ARENA_HIST_BUCKETS]; 3];
+        let key = 0u32.to_ne_bytes();
 
+        if let Ok(Some(per_cpu)) = self
+            .skel
+            .maps
+            .latency_hists
+            .lookup_percpu(&key, libbpf_rs::MapFlags::ANY)
+        {
+            for cpu_copy in &per_cpu {
+                for (class, row) in merged.iter_mut().enumerate() {
+                    for (bucket, slot) in row.iter_mut().enumerate() {
+                        let off = (class * arena::ARENA_HIST_BUCKETS + bucket) * 8;
+                        if off + 8 <= cpu_copy.len() {
+                            *slot += u64::from_ne_bytes(cpu_copy[off..off + 8].try_into().unwrap());
+                        }
+                    }
+                }
+            }
+        }
+
+        merged
+    }
+
+    /// Gaming-class latency histogram (arena fast path when available)
+    fn read_gaming_latency_hist(&self) -> [u64; arena::ARENA_HIST_BUCKETS] {
+        if let Some(ref reader) = self.arena_reader {
+            return reader.snapshot().gaming_latency_hist;
+        }
+        self.read_latency_hists()[0]
+    }
+
+    fn read_ccd_loads(&self) -> Vec<(u32, u64, u64)> {
+        let mut loads = Vec::new();
+
+        // Fast path: arena stats plane (no syscalls)
+        if let Some(ref reader) = self.arena_reader {
+            let snapshot = reader.snapshot();
+            for ccd in 0..self.topology.nr_ccds.min(arena::ARENA_MAX_CCDS as u32) {
+                let load = snapshot.ccd_loads[ccd as usize];
+                loads.push((ccd, load.nr_gaming, load.nr_tasks));
+            }
+            return loads;
+        }
+
+        // Fallback: per-entry map lookups
         for ccd in 0..self.topology.nr_ccds {
             let key = ccd.to_ne_bytes();
             if let Ok(Some(value)) = self
@@ -1299,23 +2120,136 @@ impl<'a> Scheduler<'a> {
             {
                 let nr_gaming = u64::from_ne_bytes(value[0..8].try_into().unwrap_or([0; 8]));
                 let nr_tasks = u64::from_ne_bytes(value[8..16].try_into().unwrap_or([0; 8]));
+                loads.push((ccd, nr_gaming, nr_tasks));
+            }
+        }
 
-                let label = if ccd == vcache_ccd {
-                    "V-Cache"
-                } else if freq_ccd == Some(ccd) {
-                    "Freq"
-                } else {
-                    "CCD"
-                };
+        loads
+    }
+
+    /// Per-DSQ depth stats: (high-water mark, time-weighted avg depth x100).
+    ///
+    /// Matches struct dsq_depth_stat on the BPF side; the average is the
+    /// depth*time integral divided by the observation window. None when
+    /// the DSQ was never observed non-trivially.
+    fn read_dsq_depth(&self, dsq_id: u32) -> Option<(u64, u64)> {
+        let key = dsq_id.to_ne_bytes();
+        let value = self
+            .skel
+            .maps
+            .dsq_depth_stats
+            .lookup(&key, libbpf_rs::MapFlags::ANY)
+            .ok()??;
+        if value.len() < 40 {
+            return None;
+        }
+
+        let hwm = u64::from_ne_bytes(value[0..8].try_into().unwrap_or([0; 8]));
+        let depth_time_ns = u64::from_ne_bytes(value[8..16].try_into().unwrap_or([0; 8]));
+        let first_ns = u64::from_ne_bytes(value[24..32].try_into().unwrap_or([0; 8]));
+        let last_ns = u64::from_ne_bytes(value[32..40].try_into().unwrap_or([0; 8]));
+
+        if hwm == 0 {
+            return None;
+        }
+        let avg_x100 = if last_ns > first_ns {
+            depth_time_ns.saturating_mul(100) / (last_ns - first_ns)
+        } else {
+            0
+        };
+        Some((hwm, avg_x100))
+    }
+
+    /// Merge the per-CPU cross-CCD steal stats at read time, like
+    /// read_latency_hists. Returns per-CCD (steals, age_sum_ns, age_max_ns).
+    fn read_steal_stats(&self) -> [(u64, u64, u64); arena::ARENA_MAX_CCDS] {
+        const N: usize = arena::ARENA_MAX_CCDS;
+        let mut merged = [(0u64, 0u64, 0u64); N];
+        let key = 0u32.to_ne_bytes();
+
+        if let Ok(Some(per_cpu)) = self
+            .skel
+            .maps
+            .steal_stats
+            .lookup_percpu(&key, libbpf_rs::MapFlags::ANY)
+        {
+            for cpu_copy in &per_cpu {
+                for (ccd, slot) in merged.iter_mut().enumerate() {
+                    let read_u64 = |off: usize| {
+                        if off + 8 <= cpu_copy.len() {
+                            u64::from_ne_bytes(cpu_copy[off..off + 8].try_into().unwrap())
+                        } else {
+                            0
+                        }
+                    };
+                    slot.0 += read_u64(ccd * 8);
+                    slot.1 += read_u64((N + ccd) * 8);
+                    slot.2 = slot.2.max(read_u64((2 * N + ccd) * 8));
+                }
+            }
+        }
+
+        merged
+    }
 
+    /// Print per-DSQ backlog depths and cross-CCD steal latencies
+    fn print_dsq_stats(&self) {
+        const TIER_NAMES: [&str; 3] = ["gaming", "interactive", "batch"];
+
+        for ccd in 0..self.topology.nr_ccds {
+            let mut tiers = Vec::new();
+            for (prio, name) in TIER_NAMES.iter().enumerate() {
+                let dsq_id = 1 + ccd * TIER_NAMES.len() as u32 + prio as u32;
+                if let Some((hwm, avg_x100)) = self.read_dsq_depth(dsq_id) {
+                    tiers.push(format!(
+                        "{} {}/{}.{:02}",
+                        name,
+                        hwm,
+                        avg_x100 / 100,
+                        avg_x100 % 100
+                    ));
+                }
+            }
+            if !tiers.is_empty() {
+                println!("  CCD{} DSQ depth (hwm/avg): {}", ccd, tiers.join(", "));
+            }
+        }
+
+        let steals = self.read_steal_stats();
+        for (ccd, &(count, age_sum, age_max)) in steals.iter().enumerate() {
+            if count > 0 {
                 println!(
-                    "  {} CCD{}: {} tasks ({} gaming)",
-                    label, ccd, nr_tasks, nr_gaming
+                    "  CCD{} steals: {} (avg age {}us, max {}us)",
+                    ccd,
+                    count,
+                    age_sum / count / 1000,
+                    age_max / 1000
                 );
             }
         }
     }
 
+    /// Print per-CCD load statistics
+    fn print_ccd_loads(&self) {
+        let vcache_ccd = self.topology.vcache_ccd.unwrap_or(0);
+        let freq_ccd = self.topology.freq_ccd;
+
+        for (ccd, nr_gaming, nr_tasks) in self.read_ccd_loads() {
+            let label = if ccd == vcache_ccd {
+                "V-Cache"
+            } else if freq_ccd == Some(ccd) {
+                "Freq"
+            } else {
+                "CCD"
+            };
+
+            println!(
+                "  {} CCD{}: {} tasks ({} gaming)",
+                label, ccd, nr_tasks, nr_gaming
+            );
+        }
+    }
+
     /// Export stats to MangoHud-compatible CSV
     fn export_mangohud_stats(&mut self) {
         if self.mangohud_exporter.is_none() {
@@ -1348,8 +2282,9 @@ impl<'a> Scheduler<'a> {
             (jitter, late)
         };
 
-        // Calculate latency percentiles from histogram
-        let (p50, p95, p99) = mangohud::calculate_latency_percentiles(&bss.gaming_latency_hist);
+        // Calculate latency percentiles from the merged per-CPU histogram
+        let gaming_hist = self.read_gaming_latency_hist();
+        let (p50, p95, p99) = mangohud::calculate_latency_percentiles(&gaming_hist);
 
         let stats = mangohud::SchedulerStats {
             timestamp_ms: std::time::SystemTime::now()
@@ -1380,26 +2315,16 @@ impl<'a> Scheduler<'a> {
         }
     }
 
-    /// Get task counts per CCD from BPF map
+    /// Get task counts per CCD (arena snapshot when available)
     fn get_ccd_task_counts(&self) -> (u64, u64) {
         let mut ccd0 = 0u64;
         let mut ccd1 = 0u64;
 
-        for ccd in 0..self.topology.nr_ccds.min(2) {
-            let key = ccd.to_ne_bytes();
-            if let Ok(Some(value)) = self
-                .skel
-                .maps
-                .ccd_loads
-                .lookup(&key, libbpf_rs::MapFlags::ANY)
-                && value.len() >= 16
-            {
-                let nr_tasks = u64::from_ne_bytes(value[8..16].try_into().unwrap_or([0; 8]));
-                if ccd == 0 {
-                    ccd0 = nr_tasks;
-                } else {
-                    ccd1 = nr_tasks;
-                }
+        for (ccd, _nr_gaming, nr_tasks) in self.read_ccd_loads() {
+            match ccd {
+                0 => ccd0 = nr_tasks,
+                1 => ccd1 = nr_tasks,
+                _ => {}
             }
         }
 
@@ -1407,6 +2332,16 @@ impl<'a> Scheduler<'a> {
     }
 }
 
+/// Check whether the running kernel exports a symbol via /proc/kallsyms
+fn kallsyms_has_symbol(symbol: &str) -> bool {
+    let Ok(kallsyms) = std::fs::read_to_string("/proc/kallsyms") else {
+        return false;
+    };
+    kallsyms
+        .lines()
+        .any(|line| line.split_whitespace().nth(2) == Some(symbol))
+}
+
 /// Analyze MangoHud frame time log and print statistics
 fn analyze_frametime_log(path: Option<std::path::PathBuf>) -> Result<()> {
     use mangohud::MangoHudLogReader;
@@ -1423,14 +2358,13 @@ fn analyze_frametime_log(path: Option<std::path::PathBuf>) -> Result<()> {
     println!("Analyzing: {}", log_path.display());
     println!();
 
-    let frame_times = reader.read_frame_times(&log_path)?;
+    // Single streaming pass: fixed memory even on multi-hour captures
+    let stats = mangohud::StreamingFrameTimeAnalyzer::analyze_file(&log_path)?;
 
-    if frame_times.is_empty() {
+    if stats.count == 0 {
         bail!("No frame times found in log file");
     }
 
-    let stats = MangoHudLogReader::analyze_frame_times(&frame_times);
-
     println!("╔══════════════════════════════════════════╗");
     println!("║      MangoHud Frame Time Analysis        ║");
     println!("╚══════════════════════════════════════════╝");
@@ -1465,6 +2399,42 @@ fn analyze_frametime_log(path: Option<std::path::PathBuf>) -> Result<()> {
     Ok(())
 }
 
+/// Tail a live MangoHud log, printing updated stats as frames arrive
+///
+/// Incremental: each poll parses only the bytes appended since the last
+/// one, so a multi-hour session stays cheap. Runs until interrupted.
+fn follow_frametime_log(path: Option<std::path::PathBuf>) -> Result<()> {
+    use mangohud::MangoHudLogReader;
+
+    let reader = MangoHudLogReader::new();
+
+    let log_path = match path {
+        Some(p) => p,
+        None => reader
+            .find_latest_log()
+            .context("No MangoHud log found. Run a game with MangoHud first, or specify a path.")?,
+    };
+
+    println!("Following: {} (Ctrl-C to stop)", log_path.display());
+
+    let mut tailer = mangohud::FrameTimeTailer::new(log_path);
+    loop {
+        match tailer.poll() {
+            Ok(Some(stats)) => {
+                print!(
+                    "\r  {} frames | avg {:.1} fps | 1% low {:.1} | 0.1% low {:.1} | jitter {:.2} ms  ",
+                    stats.count, stats.fps_avg, stats.fps_1_low, stats.fps_01_low, stats.std_dev_ms
+                );
+                let _ = std::io::Write::flush(&mut std::io::stdout());
+            }
+            Ok(None) => {}
+            // The log can briefly vanish during rotation; keep polling
+            Err(e) => debug!("Frame time tail poll failed: {}", e),
+        }
+        std::thread::sleep(Duration::from_millis(500));
+    }
+}
+
 fn main() -> Result<()> {
     let args = Args::parse();
 
@@ -1480,6 +2450,16 @@ fn main() -> Result<()> {
         return analyze_frametime_log(path_option);
     }
 
+    // Handle live frame time tailing (doesn't require root or scheduler)
+    if let Some(path_option) = args.follow_frametime {
+        return follow_frametime_log(path_option);
+    }
+
+    // Handle event ring analysis (doesn't require root or scheduler)
+    if let Some(path_option) = args.analyze_events {
+        return recorder::analyze_events_file(path_option);
+    }
+
     // Initialize logging
     let log_level = if args.debug {
         "debug"
@@ -374,6 +374,232 @@ pub struct FrameTimeStats {
     pub fps_01_low: f64,
 }
 
+/// Streaming analyzer bucket layout: FT_BUCKETS buckets of FT_BUCKET_MS
+/// width cover 0-204.8ms (5 fps); slower frames land in the last bucket.
+const FT_BUCKETS: usize = 2048;
+const FT_BUCKET_MS: f64 = 0.1;
+
+/// Fixed-memory streaming frame time analyzer
+///
+/// Computes the same statistics as `analyze_frame_times` without holding
+/// the frame times: percentiles come from a fixed 0.1ms-resolution
+/// histogram (the same bucketed estimate `calculate_latency_percentiles`
+/// uses for scheduler latencies), avg/jitter from running sums. Memory is
+/// ~16KB whether the capture is a minute or four hours, and lines are
+/// parsed as they stream past instead of loading the CSV whole.
+pub struct StreamingFrameTimeAnalyzer {
+    buckets: Box<[u64; FT_BUCKETS]>,
+    count: u64,
+    sum: f64,
+    sum_sq: f64,
+    min: f64,
+    max: f64,
+    /// "frametime" column index, resolved from the first line seen
+    frametime_col: Option<usize>,
+    header_parsed: bool,
+}
+
+impl StreamingFrameTimeAnalyzer {
+    pub fn new() -> Self {
+        Self {
+            buckets: Box::new([0u64; FT_BUCKETS]),
+            count: 0,
+            sum: 0.0,
+            sum_sq: 0.0,
+            min: f64::INFINITY,
+            max: f64::NEG_INFINITY,
+            frametime_col: None,
+            header_parsed: false,
+        }
+    }
+
+    /// Frames recorded so far
+    pub fn count(&self) -> u64 {
+        self.count
+    }
+
+    /// Record one frame time (milliseconds)
+    pub fn record(&mut self, ft_ms: f64) {
+        if !ft_ms.is_finite() || ft_ms < 0.0 {
+            return;
+        }
+
+        let bucket = ((ft_ms / FT_BUCKET_MS) as usize).min(FT_BUCKETS - 1);
+        self.buckets[bucket] += 1;
+        self.count += 1;
+        self.sum += ft_ms;
+        self.sum_sq += ft_ms * ft_ms;
+        self.min = self.min.min(ft_ms);
+        self.max = self.max.max(ft_ms);
+    }
+
+    /// Feed one CSV line (the first line seen is treated as the header)
+    pub fn ingest_line(&mut self, line: &str) {
+        if !self.header_parsed {
+            self.header_parsed = true;
+            for (i, col) in line.split(',').enumerate() {
+                if col.trim().to_lowercase() == "frametime" {
+                    self.frametime_col = Some(i);
+                    break;
+                }
+            }
+            return;
+        }
+
+        if let Some(col) = self.frametime_col
+            && let Some(value) = line.split(',').nth(col)
+            && let Ok(ft) = value.trim().parse::<f64>()
+        {
+            self.record(ft);
+        }
+    }
+
+    /// Stream a whole log through the analyzer, one buffered line at a
+    /// time (the line buffer is reused, so memory stays fixed)
+    pub fn ingest_reader<R: std::io::BufRead>(&mut self, mut reader: R) -> Result<()> {
+        let mut line = String::new();
+        while reader.read_line(&mut line)? > 0 {
+            self.ingest_line(&line);
+            line.clear();
+        }
+        Ok(())
+    }
+
+    /// Analyze a log file in one pass
+    pub fn analyze_file(path: &PathBuf) -> Result<FrameTimeStats> {
+        let file = File::open(path)?;
+        let mut analyzer = Self::new();
+        analyzer.ingest_reader(std::io::BufReader::with_capacity(1 << 20, file))?;
+        Ok(analyzer.stats())
+    }
+
+    /// Frame time (ms) at the given percentile (e.g. 0.99 for the 1% low)
+    ///
+    /// Bucket-midpoint estimate, accurate to FT_BUCKET_MS/2; the overflow
+    /// bucket reports the observed max instead of a midpoint.
+    pub fn percentile_ms(&self, fraction: f64) -> f64 {
+        if self.count == 0 {
+            return 0.0;
+        }
+
+        // Rank of the sample `analyze_frame_times` would index
+        // ((count * fraction) as a 0-based index, so rank index + 1)
+        let threshold = ((self.count as f64 * fraction) as u64 + 1).min(self.count);
+        let mut cumulative = 0u64;
+
+        for (i, &bucket_count) in self.buckets.iter().enumerate() {
+            cumulative += bucket_count;
+            if cumulative >= threshold && bucket_count > 0 {
+                if i == FT_BUCKETS - 1 {
+                    return self.max;
+                }
+                return ((i as f64 + 0.5) * FT_BUCKET_MS).clamp(self.min, self.max);
+            }
+        }
+
+        self.max
+    }
+
+    /// Current statistics snapshot
+    pub fn stats(&self) -> FrameTimeStats {
+        if self.count == 0 {
+            return FrameTimeStats::default();
+        }
+
+        let count = self.count as f64;
+        let avg = self.sum / count;
+        // Running-sums variance; clamp against FP cancellation going negative
+        let variance = (self.sum_sq / count - avg * avg).max(0.0);
+
+        let p99 = self.percentile_ms(0.99);
+        let p999 = self.percentile_ms(0.999);
+
+        FrameTimeStats {
+            count: self.count as usize,
+            avg_ms: avg,
+            min_ms: self.min,
+            max_ms: self.max,
+            std_dev_ms: variance.sqrt(),
+            fps_avg: 1000.0 / avg,
+            fps_1_low: 1000.0 / p99,
+            fps_01_low: 1000.0 / p999,
+        }
+    }
+}
+
+impl Default for StreamingFrameTimeAnalyzer {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Incremental tail over a live MangoHud log
+///
+/// Remembers the byte offset of the last poll, parses only the bytes
+/// appended since, and carries any trailing partial line to the next
+/// poll. A shrinking file (log rotated or game restarted) resets the
+/// analyzer so stats track the new capture.
+pub struct FrameTimeTailer {
+    path: PathBuf,
+    offset: u64,
+    carry: String,
+    analyzer: StreamingFrameTimeAnalyzer,
+}
+
+impl FrameTimeTailer {
+    pub fn new(path: PathBuf) -> Self {
+        Self {
+            path,
+            offset: 0,
+            carry: String::new(),
+            analyzer: StreamingFrameTimeAnalyzer::new(),
+        }
+    }
+
+    /// Consume any bytes appended since the last poll.
+    ///
+    /// Returns Some(stats) when new frames arrived, None when the log is
+    /// idle (or mid-line).
+    pub fn poll(&mut self) -> Result<Option<FrameTimeStats>> {
+        use std::io::{Read, Seek, SeekFrom};
+
+        let mut file = File::open(&self.path)?;
+        let len = file.metadata()?.len();
+
+        if len < self.offset {
+            debug!("Frame time log truncated, restarting analysis");
+            self.offset = 0;
+            self.carry.clear();
+            self.analyzer = StreamingFrameTimeAnalyzer::new();
+        }
+        if len == self.offset {
+            return Ok(None);
+        }
+
+        file.seek(SeekFrom::Start(self.offset))?;
+        file.take(len - self.offset)
+            .read_to_string(&mut self.carry)?;
+        self.offset = len;
+
+        let frames_before = self.analyzer.count();
+
+        // Parse complete lines only; keep a trailing partial write for
+        // the next poll.
+        if let Some(last_newline) = self.carry.rfind('\n') {
+            for line in self.carry[..last_newline].lines() {
+                self.analyzer.ingest_line(line);
+            }
+            self.carry.drain(..=last_newline);
+        }
+
+        if self.analyzer.count() > frames_before {
+            Ok(Some(self.analyzer.stats()))
+        } else {
+            Ok(None)
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -394,4 +620,57 @@ mod tests {
         assert!(stats.fps_avg > 59.0 && stats.fps_avg < 61.0); // ~60 FPS
         assert!(stats.std_dev_ms < 1.0); // Low jitter
     }
+
+    #[test]
+    fn test_streaming_matches_batch_analysis() {
+        let frame_times = vec![
+            16.67, 16.68, 16.66, 17.0, 16.5, 16.7, 16.65, 16.69, 16.67, 33.3,
+        ];
+        let batch = MangoHudLogReader::analyze_frame_times(&frame_times);
+
+        let mut csv = String::from("fps,frametime,cpu_load\n");
+        for ft in &frame_times {
+            csv.push_str(&format!("60.0,{},12.5\n", ft));
+        }
+        let mut analyzer = StreamingFrameTimeAnalyzer::new();
+        analyzer
+            .ingest_reader(std::io::Cursor::new(csv.as_bytes()))
+            .unwrap();
+        let streamed = analyzer.stats();
+
+        assert_eq!(streamed.count, batch.count);
+        assert!((streamed.avg_ms - batch.avg_ms).abs() < 1e-9);
+        assert!((streamed.std_dev_ms - batch.std_dev_ms).abs() < 1e-6);
+        // Percentiles are bucket-midpoint estimates: within half a bucket
+        assert!((1000.0 / streamed.fps_1_low - 1000.0 / batch.fps_1_low).abs() <= FT_BUCKET_MS);
+    }
+
+    #[test]
+    fn test_tailer_incremental_and_truncation() {
+        use std::io::Write as _;
+
+        let dir = std::env::temp_dir().join("ghostbrew-mangohud-test");
+        fs::create_dir_all(&dir).unwrap();
+        let path = dir.join("tail.csv");
+        fs::write(&path, "frametime\n16.0\n16.5\n").unwrap();
+
+        let mut tailer = FrameTimeTailer::new(path.clone());
+        let stats = tailer.poll().unwrap().expect("initial frames");
+        assert_eq!(stats.count, 2);
+
+        // Idle poll, then an append with a partial trailing line
+        assert!(tailer.poll().unwrap().is_none());
+        let mut file = fs::OpenOptions::new().append(true).open(&path).unwrap();
+        write!(file, "17.0\n33").unwrap();
+        drop(file);
+        let stats = tailer.poll().unwrap().expect("appended frame");
+        assert_eq!(stats.count, 3); // the "33" fragment waits for its newline
+
+        // Truncation (log rotation) restarts the analysis
+        fs::write(&path, "frametime\n20.0\n").unwrap();
+        let stats = tailer.poll().unwrap().expect("post-rotation frame");
+        assert_eq!(stats.count, 1);
+
+        let _ = fs::remove_file(&path);
+    }
 }
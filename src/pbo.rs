@@ -94,6 +94,116 @@ pub fn detect_prefcore(nr_cpus: u32) -> Result<PrefcoreInfo> {
     Ok(info)
 }
 
+/// Weight of a new sample in the effective-frequency EWMA (1/4)
+const BOOST_EWMA_WEIGHT: u64 = 4;
+
+/// Samples needed before live re-ranking kicks in
+const RERANK_MIN_SAMPLES: u64 = 8;
+
+/// Background sampler tracking per-core effective frequency.
+///
+/// The firmware prefcore ranking encodes silicon quality at boot, but under
+/// sustained load the actually-fastest cores shift with thermals: a core
+/// that has exhausted its boost headroom keeps its high static rank while
+/// delivering less clock. The sampler keeps an EWMA of each core's
+/// effective frequency (amd_pstate's scaling_cur_freq, aperf/mperf derived)
+/// and blends it with the firmware ranking so the BPF-side
+/// prefcore_rankings map follows live thermal reality.
+pub struct BoostSampler {
+    /// Firmware rankings (boot-time baseline)
+    base_rankings: Vec<u32>,
+    /// EWMA of observed effective frequency per CPU (kHz)
+    avg_freq_khz: Vec<u64>,
+    /// Last rankings handed to the caller for publication
+    last_rankings: Vec<u32>,
+    samples: u64,
+}
+
+impl BoostSampler {
+    pub fn new(base_rankings: Vec<u32>) -> Self {
+        let nr_cpus = base_rankings.len();
+        Self {
+            last_rankings: base_rankings.clone(),
+            base_rankings,
+            avg_freq_khz: vec![0; nr_cpus],
+            samples: 0,
+        }
+    }
+
+    /// Take one effective-frequency sample per CPU
+    pub fn sample(&mut self) {
+        for cpu in 0..self.base_rankings.len() {
+            let Some(freq) = read_effective_freq_khz(cpu as u32) else {
+                continue;
+            };
+
+            let avg = &mut self.avg_freq_khz[cpu];
+            if *avg == 0 {
+                *avg = freq;
+            } else {
+                *avg = (*avg * (BOOST_EWMA_WEIGHT - 1) + freq) / BOOST_EWMA_WEIGHT;
+            }
+        }
+        self.samples += 1;
+    }
+
+    /// Produce updated rankings when live telemetry diverged from the last
+    /// published set. Returns None during warmup or while rankings are
+    /// stable (hysteresis keeps BPF map churn down).
+    pub fn rerank(&mut self) -> Option<Vec<u32>> {
+        if self.samples < RERANK_MIN_SAMPLES {
+            return None;
+        }
+
+        let candidate = blended_rankings(&self.base_rankings, &self.avg_freq_khz);
+
+        // Republish only when some core moved by more than ~6% of scale
+        let max_base = self.base_rankings.iter().max().copied().unwrap_or(0);
+        let threshold = (max_base / 16).max(1);
+        let moved = candidate
+            .iter()
+            .zip(self.last_rankings.iter())
+            .any(|(&new, &old)| new.abs_diff(old) > threshold);
+        if !moved {
+            return None;
+        }
+
+        self.last_rankings = candidate.clone();
+        Some(candidate)
+    }
+}
+
+/// Blend firmware rankings with live effective frequency, 50/50, on the
+/// firmware ranking scale. Cores without frequency data keep their
+/// firmware rank.
+fn blended_rankings(base: &[u32], avg_freq_khz: &[u64]) -> Vec<u32> {
+    let max_base = base.iter().max().copied().unwrap_or(0) as u64;
+    let max_freq = avg_freq_khz.iter().max().copied().unwrap_or(0);
+    if max_base == 0 || max_freq == 0 {
+        return base.to_vec();
+    }
+
+    base.iter()
+        .zip(avg_freq_khz.iter())
+        .map(|(&b, &freq)| {
+            if freq == 0 {
+                return b;
+            }
+            let live = freq * max_base / max_freq;
+            ((b as u64 + live + 1) / 2) as u32
+        })
+        .collect()
+}
+
+/// Read a CPU's effective frequency in kHz from cpufreq
+fn read_effective_freq_khz(cpu: u32) -> Option<u64> {
+    let path = format!(
+        "/sys/devices/system/cpu/cpufreq/policy{}/scaling_cur_freq",
+        cpu
+    );
+    fs::read_to_string(&path).ok()?.trim().parse().ok()
+}
+
 /// Get the current EPP (Energy Performance Preference) for a CPU
 pub fn get_cpu_epp(cpu: u32) -> Result<String> {
     let path = format!(
@@ -242,6 +352,31 @@ mod tests {
         let _mode = detect_pstate_mode();
     }
 
+    #[test]
+    fn test_blended_rankings_follow_thermals() {
+        // Two "identical" cores by firmware rank; core 1 sustains a higher
+        // effective clock, so it must out-rank core 0
+        let base = vec![255, 255, 166];
+        let blended = blended_rankings(&base, &[4_800_000, 5_400_000, 4_400_000]);
+        assert!(blended[1] > blended[0]);
+        assert!(blended[2] < blended[0]);
+
+        // No telemetry -> firmware rankings pass through unchanged
+        assert_eq!(blended_rankings(&base, &[0, 0, 0]), base);
+    }
+
+    #[test]
+    fn test_boost_sampler_hysteresis() {
+        let mut sampler = BoostSampler::new(vec![255, 231]);
+        // Warmup: no re-rank before enough samples
+        assert!(sampler.rerank().is_none());
+        for _ in 0..RERANK_MIN_SAMPLES {
+            sampler.samples += 1;
+        }
+        // Without frequency data the candidate equals the baseline: stable
+        assert!(sampler.rerank().is_none());
+    }
+
     #[test]
     fn test_detect_prefcore() {
         // This just tests basic functionality
@@ -6,15 +6,16 @@
 //
 // Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
 
+use aho_corasick::AhoCorasick;
 use anyhow::{Context, Result};
 use log::{debug, info, warn};
 use serde::{Deserialize, Serialize};
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::fs;
 use std::path::PathBuf;
 
 /// Game profile configuration
-#[derive(Debug, Clone, Serialize, Deserialize)]
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
 pub struct GameProfile {
     /// Profile name (e.g., "Cyberpunk 2077")
     pub name: String,
@@ -127,6 +128,14 @@ pub struct ProfileManager {
     by_exe: HashMap<String, String>,
     /// Index by Steam App ID for fast lookup
     by_appid: HashMap<u32, String>,
+    /// All exe-name patterns compiled into one case-insensitive automaton,
+    /// so substring matching is a single pass regardless of profile count
+    exe_automaton: Option<AhoCorasick>,
+    /// Profile name for each automaton pattern, by pattern index
+    automaton_profiles: Vec<String>,
+    /// PIDs that already failed to match any profile; long-lived
+    /// non-game processes are looked up once, not on every rescan
+    negative_cache: HashSet<u32>,
 }
 
 impl ProfileManager {
@@ -136,6 +145,9 @@ impl ProfileManager {
             profiles: HashMap::new(),
             by_exe: HashMap::new(),
             by_appid: HashMap::new(),
+            exe_automaton: None,
+            automaton_profiles: Vec::new(),
+            negative_cache: HashSet::new(),
         }
     }
 
@@ -166,9 +178,38 @@ impl ProfileManager {
         }
 
         info!("Loaded {} game profiles from {:?}", count, dir);
+        self.rebuild_exe_automaton();
         Ok(count)
     }
 
+    /// Rebuild the exe-pattern automaton after profiles change. Also drops
+    /// the negative cache, since a new profile may match a cached PID.
+    fn rebuild_exe_automaton(&mut self) {
+        self.automaton_profiles.clear();
+        self.negative_cache.clear();
+
+        let mut patterns = Vec::with_capacity(self.by_exe.len());
+        for (pattern, profile_name) in &self.by_exe {
+            patterns.push(pattern.clone());
+            self.automaton_profiles.push(profile_name.clone());
+        }
+
+        self.exe_automaton = if patterns.is_empty() {
+            None
+        } else {
+            match AhoCorasick::builder()
+                .ascii_case_insensitive(true)
+                .build(&patterns)
+            {
+                Ok(ac) => Some(ac),
+                Err(e) => {
+                    warn!("Failed to build profile matcher: {}", e);
+                    None
+                }
+            }
+        };
+    }
+
     /// Load profiles from standard paths
     pub fn load_standard_paths(&mut self) -> Result<usize> {
         let paths = vec![
@@ -217,31 +258,76 @@ impl ProfileManager {
         self.profiles.insert(name, profile);
     }
 
-    /// Match a process to a profile by exe name or Steam App ID
-    pub fn match_process(&self, exe_name: &str, steam_appid: Option<u32>) -> Option<&GameProfile> {
+    /// Add a profile directly and rebuild the matcher
+    ///
+    /// For programmatic population (replay bench, tests); the TOML load
+    /// path batches inserts and rebuilds once instead.
+    pub fn insert_profile(&mut self, profile: GameProfile) {
+        self.add_profile(profile);
+        self.rebuild_exe_automaton();
+    }
+
+    /// Resolve a process to a profile name by exe name or Steam App ID
+    fn match_profile_name(&self, exe_name: &str, steam_appid: Option<u32>) -> Option<&String> {
         // Try Steam App ID first (most specific)
         if let Some(appid) = steam_appid
             && let Some(profile_name) = self.by_appid.get(&appid)
         {
-            return self.profiles.get(profile_name);
+            return Some(profile_name);
         }
 
         // Try exact exe name match (case-insensitive)
         let exe_lower = exe_name.to_lowercase();
         if let Some(profile_name) = self.by_exe.get(&exe_lower) {
-            return self.profiles.get(profile_name);
+            return Some(profile_name);
         }
 
-        // Try partial exe name match (e.g., "Cyberpunk2077.exe" contains "cyberpunk")
-        for (pattern, profile_name) in &self.by_exe {
-            if exe_lower.contains(pattern) || pattern.contains(&exe_lower) {
-                return self.profiles.get(profile_name);
-            }
+        // Partial match (e.g., "Cyberpunk2077.exe" contains "cyberpunk"):
+        // one automaton pass over the exe name instead of a loop over all
+        // loaded patterns
+        if let Some(ac) = &self.exe_automaton
+            && let Some(m) = ac.find(exe_name)
+        {
+            return self.automaton_profiles.get(m.pattern().as_usize());
         }
 
         None
     }
 
+    /// Match a process to a profile by exe name or Steam App ID
+    pub fn match_process(&self, exe_name: &str, steam_appid: Option<u32>) -> Option<&GameProfile> {
+        let profile_name = self.match_profile_name(exe_name, steam_appid)?;
+        self.profiles.get(profile_name)
+    }
+
+    /// Like [`match_process`](Self::match_process), but remembers PIDs that
+    /// matched nothing so repeated rescans of long-lived processes skip the
+    /// string work entirely. Pair with [`forget_pid`](Self::forget_pid)
+    /// when the process exits.
+    pub fn match_process_for_pid(
+        &mut self,
+        pid: u32,
+        exe_name: &str,
+        steam_appid: Option<u32>,
+    ) -> Option<&GameProfile> {
+        if self.negative_cache.contains(&pid) {
+            return None;
+        }
+
+        match self.match_profile_name(exe_name, steam_appid).cloned() {
+            Some(profile_name) => self.profiles.get(&profile_name),
+            None => {
+                self.negative_cache.insert(pid);
+                None
+            }
+        }
+    }
+
+    /// Drop cached match state for an exited process
+    pub fn forget_pid(&mut self, pid: u32) {
+        self.negative_cache.remove(&pid);
+    }
+
     /// Get all profiles (for iteration)
     pub fn all_profiles(&self) -> impl Iterator<Item = &GameProfile> {
         self.profiles.values()
@@ -286,6 +372,41 @@ work_mode = true
         assert_eq!(profile.smt_preference, SmtPreference::PreferIdle);
     }
 
+    #[test]
+    fn test_match_automaton_and_negative_cache() {
+        let mut mgr = ProfileManager::new();
+        mgr.add_profile(GameProfile {
+            name: "Cyberpunk 2077".to_string(),
+            exe_name: Some("cyberpunk".to_string()),
+            steam_appid: Some(1091500),
+            comm_pattern: None,
+            tunables: ProfileTunables::default(),
+            vcache_preference: VCachePreference::default(),
+            smt_preference: SmtPreference::default(),
+            numa_preference: NumaPreference::default(),
+            cpu_affinity: None,
+        });
+        mgr.rebuild_exe_automaton();
+
+        // App ID, exact exe, and automaton substring matching
+        assert!(mgr.match_process("whatever", Some(1091500)).is_some());
+        assert!(mgr.match_process("cyberpunk", None).is_some());
+        assert!(mgr.match_process("Cyberpunk2077.exe", None).is_some());
+        assert!(mgr.match_process("firefox", None).is_none());
+
+        // Negative result is cached per PID and cleared on forget
+        assert!(mgr.match_process_for_pid(42, "firefox", None).is_none());
+        assert!(mgr.negative_cache.contains(&42));
+        assert!(mgr.match_process_for_pid(42, "firefox", None).is_none());
+        mgr.forget_pid(42);
+        assert!(!mgr.negative_cache.contains(&42));
+
+        // Reload clears the negative cache
+        mgr.match_process_for_pid(43, "firefox", None);
+        mgr.rebuild_exe_automaton();
+        assert!(mgr.negative_cache.is_empty());
+    }
+
     #[test]
     fn test_profile_numa_preference() {
         let toml_str = r#"
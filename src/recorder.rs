@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: GPL-2.0
+//
+// GhostBrew - Event Flight Recorder
+//
+// High-rate event capture for offline stutter analysis. The ringbuf handler
+// normally formats every event into a String for logging, which allocates on
+// the hot path and makes EVENT_HIGH_LATENCY storms perturb the very
+// latencies they report. In flight-recorder mode each raw fixed-layout
+// `SchedEvent` (56 bytes) is copied straight into an mmapped ring file with
+// no formatting or allocation; `--analyze-events` decodes the file after the
+// session.
+//
+// File layout: a 64-byte header followed by `capacity` fixed-size record
+// slots. `write_idx` counts records ever written, so the decoder knows both
+// where the ring wrapped and which slot holds the oldest record.
+//
+// Copyright (C) 2025-2026 ghostkellz <ckelley@ghostkellz.sh>
+
+use anyhow::{Context, Result, bail};
+use log::info;
+use std::collections::HashMap;
+use std::fs;
+use std::os::fd::AsRawFd;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use crate::events::SchedEvent;
+
+/// Default ring file location (also used by --analyze-events without a path)
+pub const DEFAULT_RING_PATH: &str = "/var/log/ghostbrew/events.bin";
+
+const RING_MAGIC: u32 = 0x4742_4652; // "GBFR"
+const RING_VERSION: u32 = 1;
+const HEADER_LEN: usize = 64;
+const RECORD_LEN: usize = std::mem::size_of::<SchedEvent>();
+
+/// Default ring capacity in records (~56 MiB): hours of capture at the
+/// steady-state event rate, minutes under a worst-case latency storm
+const DEFAULT_CAPACITY: u64 = 1 << 20;
+
+/// Byte offset of the write_idx field within the header
+const WRITE_IDX_OFFSET: usize = 16;
+
+/// Appends raw scheduler events into an mmapped ring file
+pub struct FlightRecorder {
+    base: *mut u8,
+    map_len: usize,
+    capacity: u64,
+    write_idx: AtomicU64,
+}
+
+// The mapping is owned by the recorder and unmapped in Drop; record() only
+// uses atomic index allocation plus raw copies into distinct slots.
+unsafe impl Send for FlightRecorder {}
+unsafe impl Sync for FlightRecorder {}
+
+impl FlightRecorder {
+    /// Create (truncating) the ring file and map it for writing
+    pub fn create(path: &Path) -> Result<Self> {
+        if let Some(parent) = path.parent() {
+            fs::create_dir_all(parent).with_context(|| format!("Failed to create {:?}", parent))?;
+        }
+
+        let file = fs::OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(path)
+            .with_context(|| format!("Failed to create ring file {:?}", path))?;
+
+        let map_len = HEADER_LEN + (DEFAULT_CAPACITY as usize) * RECORD_LEN;
+        file.set_len(map_len as u64)
+            .context("Failed to size ring file")?;
+
+        let base = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                map_len,
+                libc::PROT_READ | libc::PROT_WRITE,
+                libc::MAP_SHARED,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if base == libc::MAP_FAILED {
+            bail!("Failed to mmap ring file {:?}", path);
+        }
+        let base = base as *mut u8;
+
+        // Write the header; write_idx starts at 0
+        unsafe {
+            std::ptr::write_unaligned(base as *mut u32, RING_MAGIC);
+            std::ptr::write_unaligned(base.add(4) as *mut u32, RING_VERSION);
+            std::ptr::write_unaligned(base.add(8) as *mut u32, RECORD_LEN as u32);
+            std::ptr::write_unaligned(base.add(12) as *mut u32, DEFAULT_CAPACITY as u32);
+            std::ptr::write_unaligned(base.add(WRITE_IDX_OFFSET) as *mut u64, 0u64);
+        }
+
+        info!(
+            "Flight recorder: {:?} ({} record slots, {} MiB)",
+            path,
+            DEFAULT_CAPACITY,
+            map_len / (1024 * 1024)
+        );
+
+        Ok(Self {
+            base,
+            map_len,
+            capacity: DEFAULT_CAPACITY,
+            write_idx: AtomicU64::new(0),
+        })
+    }
+
+    /// Append one raw event; no allocation, no formatting
+    pub fn record(&self, data: &[u8]) {
+        if data.len() < RECORD_LEN {
+            return;
+        }
+
+        let idx = self.write_idx.fetch_add(1, Ordering::Relaxed);
+        let slot = (idx % self.capacity) as usize;
+
+        unsafe {
+            let dst = self.base.add(HEADER_LEN + slot * RECORD_LEN);
+            std::ptr::copy_nonoverlapping(data.as_ptr(), dst, RECORD_LEN);
+            // Publish after the record body so the decoder never sees a
+            // half-written newest slot as valid.
+            std::ptr::write_volatile(self.base.add(WRITE_IDX_OFFSET) as *mut u64, idx + 1);
+        }
+    }
+}
+
+impl Drop for FlightRecorder {
+    fn drop(&mut self) {
+        unsafe {
+            libc::munmap(self.base as *mut libc::c_void, self.map_len);
+        }
+    }
+}
+
+/// Decode header fields from a ring file image
+fn parse_header(data: &[u8]) -> Result<(u32, u64, u64)> {
+    if data.len() < HEADER_LEN {
+        bail!("Ring file too short for header");
+    }
+
+    let magic = u32::from_le_bytes(data[0..4].try_into().unwrap());
+    let version = u32::from_le_bytes(data[4..8].try_into().unwrap());
+    let record_len = u32::from_le_bytes(data[8..12].try_into().unwrap());
+    let capacity = u32::from_le_bytes(data[12..16].try_into().unwrap());
+    let write_idx = u64::from_le_bytes(data[16..24].try_into().unwrap());
+
+    if magic != RING_MAGIC {
+        bail!("Not a GhostBrew event ring (bad magic)");
+    }
+    if version != RING_VERSION {
+        bail!("Unsupported ring version {}", version);
+    }
+    if record_len as usize != RECORD_LEN {
+        bail!(
+            "Record size mismatch: file has {}, expected {} (different build?)",
+            record_len,
+            RECORD_LEN
+        );
+    }
+
+    Ok((record_len, capacity as u64, write_idx))
+}
+
+/// Iterate valid records oldest-first
+fn for_each_record(data: &[u8], capacity: u64, write_idx: u64, mut f: impl FnMut(&SchedEvent)) {
+    let start = write_idx.saturating_sub(capacity);
+
+    for idx in start..write_idx {
+        let slot = (idx % capacity) as usize;
+        let offset = HEADER_LEN + slot * RECORD_LEN;
+        if offset + RECORD_LEN > data.len() {
+            break;
+        }
+
+        // Safety: bounds checked above; SchedEvent is repr(C) and valid for
+        // any byte pattern.
+        let event =
+            unsafe { std::ptr::read_unaligned(data[offset..].as_ptr() as *const SchedEvent) };
+        f(&event);
+    }
+}
+
+/// Load all valid records from a ring file, oldest-first
+///
+/// Used by the replay harness to feed captured sessions back through the
+/// userspace decision paths.
+pub fn load_events(path: &Path) -> Result<Vec<SchedEvent>> {
+    let data = fs::read(path).with_context(|| format!("Failed to read {:?}", path))?;
+    let (_, capacity, write_idx) = parse_header(&data)?;
+
+    let mut events = Vec::with_capacity(write_idx.min(capacity) as usize);
+    for_each_record(&data, capacity, write_idx, |event| events.push(*event));
+    Ok(events)
+}
+
+/// Offline decoder for --analyze-events: summarize a captured session
+pub fn analyze_events_file(path: Option<PathBuf>) -> Result<()> {
+    let path = path.unwrap_or_else(|| PathBuf::from(DEFAULT_RING_PATH));
+    let data = fs::read(&path).with_context(|| format!("Failed to read {:?}", path))?;
+
+    let (_, capacity, write_idx) = parse_header(&data)?;
+    let nr_records = write_idx.min(capacity);
+
+    println!("GhostBrew event recording: {:?}", path);
+    println!(
+        "  Records: {} ({} written total{})",
+        nr_records,
+        write_idx,
+        if write_idx > capacity {
+            ", ring wrapped - oldest events lost"
+        } else {
+            ""
+        }
+    );
+
+    if nr_records == 0 {
+        return Ok(());
+    }
+
+    let mut first_ts = u64::MAX;
+    let mut last_ts = 0u64;
+    let mut type_counts: HashMap<&'static str, u64> = HashMap::new();
+    let mut hl_count = 0u64;
+    let mut hl_sum_us = 0u64;
+    let mut hl_max_us = 0u64;
+    let mut hl_max_event: Option<SchedEvent> = None;
+    let mut hl_by_comm: HashMap<String, u64> = HashMap::new();
+
+    for_each_record(&data, capacity, write_idx, |event| {
+        first_ts = first_ts.min(event.timestamp_ns);
+        last_ts = last_ts.max(event.timestamp_ns);
+        *type_counts.entry(event.event_name()).or_insert(0) += 1;
+
+        if event.event_type == crate::events::EVENT_HIGH_LATENCY {
+            hl_count += 1;
+            hl_sum_us += event.value1;
+            if event.value1 > hl_max_us {
+                hl_max_us = event.value1;
+                hl_max_event = Some(*event);
+            }
+            *hl_by_comm.entry(event.comm_str()).or_insert(0) += 1;
+        }
+    });
+
+    let span_s = last_ts.saturating_sub(first_ts) as f64 / 1e9;
+    println!("  Span: {:.1}s", span_s);
+
+    let mut types: Vec<(&str, u64)> = type_counts.into_iter().collect();
+    types.sort_by(|a, b| b.1.cmp(&a.1));
+    for (name, count) in types {
+        println!("  {}: {}", name, count);
+    }
+
+    if hl_count > 0 {
+        println!(
+            "  High latency: {} events, avg {}us, max {}us",
+            hl_count,
+            hl_sum_us / hl_count,
+            hl_max_us
+        );
+        if let Some(worst) = hl_max_event {
+            println!(
+                "    Worst: {} (PID {}) on CPU {} at +{:.3}s",
+                worst.comm_str(),
+                worst.pid,
+                worst.cpu,
+                worst.timestamp_ns.saturating_sub(first_ts) as f64 / 1e9
+            );
+        }
+
+        let mut offenders: Vec<(String, u64)> = hl_by_comm.into_iter().collect();
+        offenders.sort_by(|a, b| b.1.cmp(&a.1));
+        println!("    Top tasks:");
+        for (comm, count) in offenders.into_iter().take(5) {
+            println!("      {} x{}", comm, count);
+        }
+    }
+
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::EVENT_HIGH_LATENCY;
+
+    fn test_event(timestamp_ns: u64, value1: u64) -> SchedEvent {
+        SchedEvent {
+            timestamp_ns,
+            event_type: EVENT_HIGH_LATENCY,
+            pid: 42,
+            cpu: 3,
+            ccd: 0,
+            value1,
+            value2: 1000,
+            comm: *b"game.exe\0\0\0\0\0\0\0\0",
+        }
+    }
+
+    #[test]
+    fn test_record_roundtrip() {
+        let dir = std::env::temp_dir().join("ghostbrew-recorder-test");
+        let path = dir.join("events.bin");
+        let _ = fs::remove_file(&path);
+
+        {
+            let recorder = FlightRecorder::create(&path).unwrap();
+            for i in 0..3u64 {
+                let event = test_event(1000 + i, 2000 + i);
+                let bytes = unsafe {
+                    std::slice::from_raw_parts(&event as *const SchedEvent as *const u8, RECORD_LEN)
+                };
+                recorder.record(bytes);
+            }
+        }
+
+        let data = fs::read(&path).unwrap();
+        let (record_len, capacity, write_idx) = parse_header(&data).unwrap();
+        assert_eq!(record_len as usize, RECORD_LEN);
+        assert_eq!(capacity, DEFAULT_CAPACITY);
+        assert_eq!(write_idx, 3);
+
+        let mut seen = Vec::new();
+        for_each_record(&data, capacity, write_idx, |event| {
+            seen.push((event.timestamp_ns, event.value1, event.comm_str()));
+        });
+        assert_eq!(seen.len(), 3);
+        assert_eq!(seen[0], (1000, 2000, "game.exe".to_string()));
+        assert_eq!(seen[2], (1002, 2002, "game.exe".to_string()));
+
+        let _ = fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_parse_header_rejects_garbage() {
+        assert!(parse_header(&[0u8; 8]).is_err());
+        assert!(parse_header(&[0u8; HEADER_LEN]).is_err());
+    }
+}
@@ -62,7 +62,31 @@ const X3D_MODELS: &[&str] = &[
 ];
 
 /// Detect CPU topology
+///
+/// Tries the persisted snapshot cache first: full detection reads hundreds
+/// of per-CPU sysfs files, which dominates restart-to-attach time on big
+/// machines (every restart is a window where the kernel falls back to CFS).
+/// The snapshot is keyed on a hash of /proc/cpuinfo plus the kernel release
+/// and loads in a single read; any mismatch falls back to full detection.
 pub fn detect_topology() -> Result<CpuTopology> {
+    let source_hash = topology_source_hash();
+
+    if let Some(topology) = load_topology_snapshot(Path::new(TOPOLOGY_CACHE_PATH), source_hash) {
+        debug!("Topology loaded from snapshot cache");
+        return Ok(topology);
+    }
+
+    let topology = detect_topology_uncached()?;
+
+    if let Err(e) = save_topology_snapshot(Path::new(TOPOLOGY_CACHE_PATH), &topology, source_hash) {
+        debug!("Failed to save topology snapshot: {}", e);
+    }
+
+    Ok(topology)
+}
+
+/// Full sysfs/procfs topology detection (snapshot cache miss path)
+fn detect_topology_uncached() -> Result<CpuTopology> {
     let nr_cpus = detect_nr_cpus()?;
     let model_name = detect_model_name()?;
     let is_x3d = is_x3d_processor(&model_name);
@@ -186,6 +210,257 @@ pub fn detect_topology() -> Result<CpuTopology> {
     })
 }
 
+// ---------------------------------------------------------------------------
+// Topology snapshot cache
+//
+// Versioned binary serialization of CpuTopology. The snapshot is only valid
+// for the exact hardware and kernel it was taken on, enforced by a hash of
+// /proc/cpuinfo and the kernel release stored in the header.
+// ---------------------------------------------------------------------------
+
+const TOPOLOGY_CACHE_PATH: &str = "/var/cache/ghostbrew/topology.bin";
+const TOPOLOGY_CACHE_MAGIC: u32 = 0x4742_5450; // "GBTP"
+const TOPOLOGY_CACHE_VERSION: u32 = 1;
+
+/// Sanity cap when decoding array lengths from the snapshot
+const TOPOLOGY_CACHE_MAX_CPUS: u32 = 4096;
+
+/// FNV-1a hash of the topology sources: /proc/cpuinfo + kernel release.
+///
+/// Any CPU swap, SMT toggle, offlined core (cpuinfo changes), or kernel
+/// update invalidates the snapshot.
+fn topology_source_hash() -> u64 {
+    let cpuinfo = fs::read_to_string("/proc/cpuinfo").unwrap_or_default();
+    let release = fs::read_to_string("/proc/sys/kernel/osrelease").unwrap_or_default();
+
+    let mut hash: u64 = 0xcbf2_9ce4_8422_2325;
+    for byte in cpuinfo.bytes().chain(release.bytes()) {
+        hash ^= byte as u64;
+        hash = hash.wrapping_mul(0x0000_0100_0000_01b3);
+    }
+    hash
+}
+
+fn put_u32(buf: &mut Vec<u8>, v: u32) {
+    buf.extend_from_slice(&v.to_le_bytes());
+}
+
+fn put_u64(buf: &mut Vec<u8>, v: u64) {
+    buf.extend_from_slice(&v.to_le_bytes());
+}
+
+fn put_u32_vec(buf: &mut Vec<u8>, v: &[u32]) {
+    put_u32(buf, v.len() as u32);
+    for &x in v {
+        put_u32(buf, x);
+    }
+}
+
+fn put_opt_u32(buf: &mut Vec<u8>, v: Option<u32>) {
+    put_u32(buf, v.unwrap_or(u32::MAX));
+}
+
+/// Cursor over the snapshot bytes; every read is bounds-checked so a
+/// truncated or corrupt file decodes to None instead of panicking
+struct SnapshotReader<'a> {
+    data: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> SnapshotReader<'a> {
+    fn new(data: &'a [u8]) -> Self {
+        Self { data, pos: 0 }
+    }
+
+    fn take(&mut self, len: usize) -> Option<&'a [u8]> {
+        let end = self.pos.checked_add(len)?;
+        let slice = self.data.get(self.pos..end)?;
+        self.pos = end;
+        Some(slice)
+    }
+
+    fn get_u32(&mut self) -> Option<u32> {
+        Some(u32::from_le_bytes(self.take(4)?.try_into().ok()?))
+    }
+
+    fn get_u64(&mut self) -> Option<u64> {
+        Some(u64::from_le_bytes(self.take(8)?.try_into().ok()?))
+    }
+
+    fn get_u32_vec(&mut self) -> Option<Vec<u32>> {
+        let len = self.get_u32()?;
+        if len > TOPOLOGY_CACHE_MAX_CPUS {
+            return None;
+        }
+        (0..len).map(|_| self.get_u32()).collect()
+    }
+
+    fn get_opt_u32(&mut self) -> Option<Option<u32>> {
+        let v = self.get_u32()?;
+        Some((v != u32::MAX).then_some(v))
+    }
+}
+
+/// Serialize a topology into the snapshot wire format
+fn encode_topology_snapshot(topology: &CpuTopology, source_hash: u64) -> Vec<u8> {
+    let mut buf = Vec::with_capacity(4096);
+
+    put_u32(&mut buf, TOPOLOGY_CACHE_MAGIC);
+    put_u32(&mut buf, TOPOLOGY_CACHE_VERSION);
+    put_u64(&mut buf, source_hash);
+
+    put_u32(&mut buf, topology.nr_cpus);
+    put_u32(&mut buf, topology.nr_ccds);
+    put_opt_u32(&mut buf, topology.vcache_ccd);
+    put_u32_vec(&mut buf, &topology.cpu_to_ccd);
+    put_u32_vec(&mut buf, &topology.cpu_to_ccx);
+    put_u32_vec(&mut buf, &topology.cpu_to_node);
+    // Siblings are i32 (-1 = none); stored bit-identical as u32
+    let siblings: Vec<u32> = topology.cpu_to_sibling.iter().map(|&s| s as u32).collect();
+    put_u32_vec(&mut buf, &siblings);
+
+    buf.push(topology.smt_enabled as u8);
+    buf.push(topology.is_x3d as u8);
+    buf.push(topology.is_intel_hybrid as u8);
+    buf.push(topology.asymmetric_ccd_boost as u8);
+
+    put_u32(&mut buf, topology.model_name.len() as u32);
+    buf.extend_from_slice(topology.model_name.as_bytes());
+
+    match &topology.arch {
+        CpuArch::Generic => buf.push(0),
+        CpuArch::AmdZen { is_x3d, generation } => {
+            buf.push(1);
+            buf.push(*is_x3d as u8);
+            put_u32(&mut buf, *generation);
+        }
+        CpuArch::IntelHybrid { generation } => {
+            buf.push(2);
+            put_u32(&mut buf, *generation);
+        }
+    }
+
+    put_u32_vec(&mut buf, &topology.pcore_cpus);
+    put_u32_vec(&mut buf, &topology.ecore_cpus);
+    put_u32_vec(&mut buf, &topology.turbo_rankings);
+
+    put_opt_u32(&mut buf, topology.zen_generation);
+    put_opt_u32(&mut buf, topology.freq_ccd);
+    put_opt_u32(&mut buf, topology.vcache_l3_mb);
+
+    buf
+}
+
+/// Deserialize a snapshot, validating header and expected hash
+fn decode_topology_snapshot(data: &[u8], expected_hash: u64) -> Option<CpuTopology> {
+    let mut r = SnapshotReader::new(data);
+
+    if r.get_u32()? != TOPOLOGY_CACHE_MAGIC {
+        return None;
+    }
+    if r.get_u32()? != TOPOLOGY_CACHE_VERSION {
+        return None;
+    }
+    if r.get_u64()? != expected_hash {
+        return None;
+    }
+
+    let nr_cpus = r.get_u32()?;
+    if nr_cpus == 0 || nr_cpus > TOPOLOGY_CACHE_MAX_CPUS {
+        return None;
+    }
+    let nr_ccds = r.get_u32()?;
+    let vcache_ccd = r.get_opt_u32()?;
+    let cpu_to_ccd = r.get_u32_vec()?;
+    let cpu_to_ccx = r.get_u32_vec()?;
+    let cpu_to_node = r.get_u32_vec()?;
+    let cpu_to_sibling: Vec<i32> = r.get_u32_vec()?.iter().map(|&s| s as i32).collect();
+
+    // All per-CPU arrays must match the CPU count
+    if cpu_to_ccd.len() != nr_cpus as usize
+        || cpu_to_ccx.len() != nr_cpus as usize
+        || cpu_to_node.len() != nr_cpus as usize
+        || cpu_to_sibling.len() != nr_cpus as usize
+    {
+        return None;
+    }
+
+    let flags = r.take(4)?;
+    let (smt_enabled, is_x3d, is_intel_hybrid, asymmetric_ccd_boost) =
+        (flags[0] != 0, flags[1] != 0, flags[2] != 0, flags[3] != 0);
+
+    let name_len = r.get_u32()? as usize;
+    if name_len > 256 {
+        return None;
+    }
+    let model_name = String::from_utf8(r.take(name_len)?.to_vec()).ok()?;
+
+    let arch = match r.take(1)?[0] {
+        0 => CpuArch::Generic,
+        1 => {
+            let arch_x3d = r.take(1)?[0] != 0;
+            CpuArch::AmdZen {
+                is_x3d: arch_x3d,
+                generation: r.get_u32()?,
+            }
+        }
+        2 => CpuArch::IntelHybrid {
+            generation: r.get_u32()?,
+        },
+        _ => return None,
+    };
+
+    let pcore_cpus = r.get_u32_vec()?;
+    let ecore_cpus = r.get_u32_vec()?;
+    let turbo_rankings = r.get_u32_vec()?;
+
+    let zen_generation = r.get_opt_u32()?;
+    let freq_ccd = r.get_opt_u32()?;
+    let vcache_l3_mb = r.get_opt_u32()?;
+
+    Some(CpuTopology {
+        nr_cpus,
+        nr_ccds,
+        vcache_ccd,
+        cpu_to_ccd,
+        cpu_to_ccx,
+        cpu_to_node,
+        cpu_to_sibling,
+        smt_enabled,
+        is_x3d,
+        model_name,
+        arch,
+        is_intel_hybrid,
+        pcore_cpus,
+        ecore_cpus,
+        turbo_rankings,
+        zen_generation,
+        freq_ccd,
+        vcache_l3_mb,
+        asymmetric_ccd_boost,
+    })
+}
+
+/// Load and validate a topology snapshot; None means "do full detection"
+fn load_topology_snapshot(path: &Path, expected_hash: u64) -> Option<CpuTopology> {
+    let data = fs::read(path).ok()?;
+    decode_topology_snapshot(&data, expected_hash)
+}
+
+/// Persist a topology snapshot (best effort - failure just means the next
+/// restart pays for full detection again)
+fn save_topology_snapshot(path: &Path, topology: &CpuTopology, source_hash: u64) -> Result<()> {
+    if let Some(dir) = path.parent() {
+        fs::create_dir_all(dir).with_context(|| format!("Failed to create {}", dir.display()))?;
+    }
+
+    // Write-then-rename so a crash mid-write never leaves a torn snapshot
+    let tmp = path.with_extension("tmp");
+    fs::write(&tmp, encode_topology_snapshot(topology, source_hash))
+        .with_context(|| format!("Failed to write {}", tmp.display()))?;
+    fs::rename(&tmp, path).with_context(|| format!("Failed to move snapshot to {}", path.display()))
+}
+
 /// Detect CPU family from /proc/cpuinfo
 /// Family 25 = Zen 3/4, Family 26 = Zen 5
 fn detect_cpu_family() -> u32 {
@@ -732,6 +1007,64 @@ mod tests {
         assert_eq!(sanitize_cluster_id(None), None);
     }
 
+    fn fixture_topology() -> CpuTopology {
+        CpuTopology {
+            nr_cpus: 4,
+            nr_ccds: 2,
+            vcache_ccd: Some(0),
+            cpu_to_ccd: vec![0, 0, 1, 1],
+            cpu_to_ccx: vec![0, 0, 1, 1],
+            cpu_to_node: vec![0, 0, 0, 0],
+            cpu_to_sibling: vec![2, 3, 0, 1],
+            smt_enabled: true,
+            is_x3d: true,
+            model_name: "AMD Ryzen 9 9950X3D".to_string(),
+            arch: CpuArch::AmdZen {
+                is_x3d: true,
+                generation: 5,
+            },
+            is_intel_hybrid: false,
+            pcore_cpus: vec![],
+            ecore_cpus: vec![],
+            turbo_rankings: vec![231, 226, 255, 250],
+            zen_generation: Some(5),
+            freq_ccd: Some(1),
+            vcache_l3_mb: Some(96),
+            asymmetric_ccd_boost: true,
+        }
+    }
+
+    #[test]
+    fn test_topology_snapshot_roundtrip() {
+        let topo = fixture_topology();
+        let encoded = encode_topology_snapshot(&topo, 0xdead_beef);
+
+        let decoded =
+            decode_topology_snapshot(&encoded, 0xdead_beef).expect("snapshot should decode");
+        assert_eq!(decoded.nr_cpus, topo.nr_cpus);
+        assert_eq!(decoded.nr_ccds, topo.nr_ccds);
+        assert_eq!(decoded.vcache_ccd, topo.vcache_ccd);
+        assert_eq!(decoded.cpu_to_ccd, topo.cpu_to_ccd);
+        assert_eq!(decoded.cpu_to_sibling, topo.cpu_to_sibling);
+        assert_eq!(decoded.model_name, topo.model_name);
+        assert_eq!(decoded.arch, topo.arch);
+        assert_eq!(decoded.turbo_rankings, topo.turbo_rankings);
+        assert_eq!(decoded.freq_ccd, topo.freq_ccd);
+        assert_eq!(decoded.asymmetric_ccd_boost, topo.asymmetric_ccd_boost);
+    }
+
+    #[test]
+    fn test_topology_snapshot_rejects_stale_or_corrupt() {
+        let topo = fixture_topology();
+        let encoded = encode_topology_snapshot(&topo, 0xdead_beef);
+
+        // Hash mismatch (different hardware/kernel) must miss
+        assert!(decode_topology_snapshot(&encoded, 0x1234).is_none());
+
+        // Truncated snapshot must not panic or decode
+        assert!(decode_topology_snapshot(&encoded[..encoded.len() / 2], 0xdead_beef).is_none());
+    }
+
     #[test]
     fn test_cpu_arch_detection() {
         // AMD Zen 4 X3D should be detected
@@ -16,6 +16,12 @@ use std::fs;
 use std::path::PathBuf;
 use std::time::{Duration, Instant};
 
+/// A batch cohort averaging at least this L3 miss ratio (percent, from
+/// the l3miss sampler) gains more from the 96MB L3 than from the
+/// frequency CCD's clocks, so automatic switching keeps cache mode even
+/// with no gaming tasks around.
+const BATCH_CACHE_HOT_SCORE: u32 = 60;
+
 /// V-Cache operating mode
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum VCacheMode {
@@ -197,11 +203,14 @@ impl VCacheController {
 
     /// Evaluate whether a mode switch is needed based on workload metrics
     ///
-    /// For automatic strategy, decides based on gaming task count.
+    /// For automatic strategy, decides based on gaming task count, with
+    /// the batch cohort's measured cache sensitivity (average L3 miss
+    /// ratio, None = unmeasured) weighing in when no game is running.
     pub fn evaluate_switch(
         &mut self,
         nr_gaming_tasks: u64,
         nr_batch_tasks: u64,
+        batch_cache_score: Option<u32>,
     ) -> Option<VCacheMode> {
         match &self.strategy {
             SwitchingStrategy::Manual | SwitchingStrategy::FollowGhostVcache => None,
@@ -213,7 +222,14 @@ impl VCacheController {
                 let target = if nr_gaming_tasks >= *gaming_threshold as u64 {
                     VCacheMode::Cache
                 } else if nr_batch_tasks >= *batch_threshold as u64 && nr_gaming_tasks == 0 {
-                    VCacheMode::Frequency
+                    // A measurably cache-hungry batch load keeps cache
+                    // mode; switching it to the frequency CCD would just
+                    // trade L3 hits for clocks it can't use.
+                    if batch_cache_score.is_some_and(|score| score >= BATCH_CACHE_HOT_SCORE) {
+                        VCacheMode::Cache
+                    } else {
+                        VCacheMode::Frequency
+                    }
                 } else {
                     return None; // No clear signal
                 };